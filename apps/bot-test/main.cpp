@@ -1,4 +1,7 @@
 // SPDX-License-Identifier: AGPL-3.0-only
+#include "tournament.hpp"
+
+#include <bim/game/arena.hpp>
 #include <bim/game/bot.hpp>
 #include <bim/game/component/player_action.hpp>
 #include <bim/game/constant/default_arena_size.hpp>
@@ -11,6 +14,7 @@
 #include <bim/game/dump_arena.hpp>
 #include <bim/game/feature_flags_string.hpp>
 #include <bim/game/player_action.hpp>
+#include <bim/game/world_analysis.hpp>
 
 #include <bim/assume.hpp>
 #include <bim/tracy.hpp>
@@ -26,6 +30,7 @@
 #include <iostream>
 #include <optional>
 #include <random>
+#include <thread>
 
 namespace
 {
@@ -41,6 +46,11 @@ namespace
     std::string output_file;
     bool timeline;
     bool console_log;
+
+    /// Zero to play a single contest.
+    std::uint32_t tournament_seed_count;
+    std::size_t thread_count;
+    tournament_report_format report_format;
   };
 
   struct command_line
@@ -133,6 +143,19 @@ static command_line parse_command_line(int argc, char* argv[])
       "stdout.");
   options.add_options()("timeline", "Output a (binary) timeline. Default is "
                                     "to dump the game state in text.");
+  options.add_options()(
+      "tournament", boost::program_options::value<std::uint32_t>(),
+      "Play this many seeds, starting from --seed, for each combination of "
+      "the features given in --features, then write a report of the results "
+      "in the output file.");
+  options.add_options()(
+      "threads", boost::program_options::value<std::size_t>(),
+      "How many contests are played in parallel in a tournament. Default is "
+      "the number of cores.");
+  options.add_options()(
+      "report-format",
+      boost::program_options::value<std::string>()->default_value("csv"),
+      "The format of the tournament report, csv or json.");
   options.add_options()("version", "Display the version number and exit.");
 
   boost::program_options::variables_map variables;
@@ -182,6 +205,29 @@ static command_line parse_command_line(int argc, char* argv[])
   result.timeline = variables.count("timeline") != 0;
   result.console_log = (variables.count("console-log") != 0);
 
+  if (variables.count("tournament") != 0)
+    result.tournament_seed_count = variables["tournament"].as<std::uint32_t>();
+  else
+    result.tournament_seed_count = 0;
+
+  if (variables.count("threads") != 0)
+    result.thread_count = variables["threads"].as<std::size_t>();
+  else
+    result.thread_count = std::thread::hardware_concurrency();
+
+  const std::string report_format =
+      variables["report-format"].as<std::string>();
+
+  if (report_format == "csv")
+    result.report_format = tournament_report_format::csv;
+  else if (report_format == "json")
+    result.report_format = tournament_report_format::json;
+  else
+    {
+      std::cerr << "--report-format should be csv or json.\n";
+      return command_line{ .options = std::nullopt, .valid = false };
+    }
+
   return command_line{ .options = std::move(result), .valid = true };
 }
 
@@ -192,15 +238,21 @@ static void run_contest(bot_vector& bots, bim::game::contest& contest,
   bim::game::contest_result result;
   entt::registry& registry = contest.registry();
 
+  // The analysis of the world is done once per tick for all the bots.
+  bim::game::world_analysis world(contest.arena().width(),
+                                  contest.arena().height());
+
   do
     {
+      world.update(contest);
+
       for (bim::game::bot& bot : bots)
         {
           bim::game::player_action* const a =
               bim::game::find_player_action_by_index(registry,
                                                      bot.player_index());
           if (a)
-            *a = bot.think(contest);
+            *a = bot.think(contest, world);
         }
 
       on_tick_begins();
@@ -234,6 +286,27 @@ int main(int argc, char* argv[])
     .arena_height = bim::game::g_default_arena_height
   };
 
+  if (options.tournament_seed_count != 0)
+    {
+      std::FILE* const output_file =
+          (options.output_file == "-")
+              ? stdout
+              : std::fopen(options.output_file.c_str(), "w");
+
+      run_tournament(output_file,
+                     { .first_seed = options.seed,
+                       .seed_count = options.tournament_seed_count,
+                       .player_count = options.player_count,
+                       .features = options.features,
+                       .thread_count = options.thread_count,
+                       .format = options.report_format });
+
+      if (output_file != stdout)
+        std::fclose(output_file);
+
+      return EXIT_SUCCESS;
+    }
+
   bot_vector bots;
   for (int i = 0; i != fingerprint.player_count; ++i)
     bots.emplace_back(i, fingerprint.arena_width, fingerprint.arena_height,
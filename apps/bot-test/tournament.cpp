@@ -0,0 +1,388 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include "tournament.hpp"
+
+#include <bim/game/bot.hpp>
+#include <bim/game/component/player_action.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/constant/default_crate_probability.hpp>
+#include <bim/game/constant/max_player_count.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/contest_result.hpp>
+#include <bim/game/feature_flags.hpp>
+#include <bim/game/feature_flags_string.hpp>
+#include <bim/game/per_player_array.hpp>
+#include <bim/game/player_action.hpp>
+#include <bim/game/world_analysis.hpp>
+
+#include <boost/container/static_vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+  /**
+   * Distribution of durations in nanoseconds, with a precision of 1/16th of
+   * the order of magnitude of the values.
+   */
+  class latency_histogram
+  {
+  public:
+    latency_histogram()
+    {
+      m_buckets.fill(0);
+    }
+
+    void add(std::uint64_t ns)
+    {
+      ++m_buckets[bucket_index(ns)];
+    }
+
+    void merge(const latency_histogram& that)
+    {
+      for (std::size_t i = 0; i != m_buckets.size(); ++i)
+        m_buckets[i] += that.m_buckets[i];
+    }
+
+    /// The lower bound of the bucket containing the given quantile.
+    std::uint64_t quantile(double q) const
+    {
+      std::uint64_t total = 0;
+
+      for (std::uint64_t c : m_buckets)
+        total += c;
+
+      if (total == 0)
+        return 0;
+
+      const std::uint64_t rank =
+          std::min<std::uint64_t>(total - 1, q * total);
+      std::uint64_t sum = 0;
+
+      for (std::size_t i = 0; i != m_buckets.size(); ++i)
+        {
+          sum += m_buckets[i];
+
+          if (sum > rank)
+            return bucket_value(i);
+        }
+
+      return bucket_value(m_buckets.size() - 1);
+    }
+
+  private:
+    static constexpr std::size_t g_sub_bucket_bits = 4;
+    static constexpr std::size_t g_sub_bucket_count = 1
+                                                      << g_sub_bucket_bits;
+
+  private:
+    static std::size_t bucket_index(std::uint64_t ns)
+    {
+      if (ns < g_sub_bucket_count)
+        return ns;
+
+      const std::size_t e = std::bit_width(ns) - 1;
+      const std::size_t sub =
+          (ns >> (e - g_sub_bucket_bits)) & (g_sub_bucket_count - 1);
+
+      return g_sub_bucket_count + (e - g_sub_bucket_bits) * g_sub_bucket_count
+             + sub;
+    }
+
+    static std::uint64_t bucket_value(std::size_t i)
+    {
+      if (i < g_sub_bucket_count)
+        return i;
+
+      const std::size_t e =
+          (i - g_sub_bucket_count) / g_sub_bucket_count + g_sub_bucket_bits;
+      const std::uint64_t sub = (i - g_sub_bucket_count) % g_sub_bucket_count;
+
+      return (g_sub_bucket_count + sub) << (e - g_sub_bucket_bits);
+    }
+
+  private:
+    std::array<std::uint64_t,
+               g_sub_bucket_count * (65 - g_sub_bucket_bits)>
+        m_buckets;
+  };
+
+  /// The aggregated results of the contests with a given set of features.
+  struct contest_stats
+  {
+    contest_stats()
+      : contest_count(0)
+      , draw_count(0)
+      , tick_count(0)
+      , max_tick_count(0)
+      , tick_duration(0)
+    {
+      win_count.fill(0);
+    }
+
+    void merge(const contest_stats& that)
+    {
+      contest_count += that.contest_count;
+      draw_count += that.draw_count;
+
+      for (std::size_t i = 0; i != win_count.size(); ++i)
+        win_count[i] += that.win_count[i];
+
+      tick_count += that.tick_count;
+      max_tick_count = std::max(max_tick_count, that.max_tick_count);
+      tick_duration += that.tick_duration;
+      think_latency.merge(that.think_latency);
+    }
+
+    std::uint32_t contest_count;
+    std::uint32_t draw_count;
+    bim::game::per_player_array<std::uint32_t> win_count;
+
+    std::uint64_t tick_count;
+    std::uint64_t max_tick_count;
+
+    /// Time spent in contest::tick().
+    std::chrono::nanoseconds tick_duration;
+
+    /**
+     * Time spent in each call to bot::think(), excluding the analysis of the
+     * world shared by the bots.
+     */
+    latency_histogram think_latency;
+  };
+}
+
+static std::vector<bim::game::feature_flags>
+feature_combinations(bim::game::feature_flags features)
+{
+  std::vector<bim::game::feature_flags> result;
+  result.push_back({});
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    if (!!(features & f))
+      for (std::size_t i = 0, n = result.size(); i != n; ++i)
+        result.push_back(result[i] | f);
+
+  return result;
+}
+
+static void play_contest(contest_stats& stats,
+                         const bim::game::contest_fingerprint& fingerprint)
+{
+  boost::container::static_vector<bim::game::bot,
+                                  bim::game::g_max_player_count>
+      bots;
+
+  for (int i = 0; i != fingerprint.player_count; ++i)
+    bots.emplace_back(i, fingerprint.arena_width, fingerprint.arena_height,
+                      fingerprint.seed + i);
+
+  bim::game::contest contest(fingerprint);
+  bim::game::contest_result result;
+  std::uint64_t tick_count = 0;
+
+  // The analysis of the world is done once per tick and shared by all the
+  // bots.
+  bim::game::world_analysis world(contest.arena().width(),
+                                  contest.arena().height());
+
+  do
+    {
+      world.update(contest);
+
+      for (bim::game::bot& bot : bots)
+        {
+          bim::game::player_action* const a =
+              bim::game::find_player_action_by_index(contest.registry(),
+                                                     bot.player_index());
+          if (!a)
+            continue;
+
+          const std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          *a = bot.think(contest, world);
+          stats.think_latency.add(
+              std::chrono::nanoseconds(std::chrono::steady_clock::now()
+                                       - start)
+                  .count());
+        }
+
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      result = contest.tick();
+      stats.tick_duration += std::chrono::steady_clock::now() - start;
+
+      ++tick_count;
+    }
+  while (result.still_running());
+
+  ++stats.contest_count;
+
+  if (result.has_a_winner())
+    ++stats.win_count[result.winning_player()];
+  else
+    ++stats.draw_count;
+
+  stats.tick_count += tick_count;
+  stats.max_tick_count = std::max(stats.max_tick_count, tick_count);
+}
+
+static std::string features_label(bim::game::feature_flags features,
+                                  const char* separator)
+{
+  std::string result;
+  const char* s = "";
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    if (!!(features & f))
+      {
+        result += s;
+        s = separator;
+        result.append(bim::game::to_simple_string(f));
+      }
+
+  return result;
+}
+
+static double ticks_per_second(const contest_stats& stats)
+{
+  const double seconds =
+      std::chrono::duration<double>(stats.tick_duration).count();
+
+  return (seconds == 0) ? 0 : (stats.tick_count / seconds);
+}
+
+static void write_csv(std::FILE* output,
+                      const std::vector<bim::game::feature_flags>& features,
+                      const std::vector<contest_stats>& stats,
+                      std::uint8_t player_count)
+{
+  fprintf(output, "features,contests,draw_rate");
+
+  for (int i = 0; i != player_count; ++i)
+    fprintf(output, ",win_rate_%d", i);
+
+  fprintf(output, ",mean_ticks,max_ticks,ticks_per_second,think_p50_ns,"
+                  "think_p99_ns\n");
+
+  for (std::size_t i = 0; i != stats.size(); ++i)
+    {
+      const contest_stats& s = stats[i];
+      const double n = std::max<std::uint32_t>(1, s.contest_count);
+
+      fprintf(output, "%s,%u,%.4f", features_label(features[i], "+").c_str(),
+              s.contest_count, s.draw_count / n);
+
+      for (int p = 0; p != player_count; ++p)
+        fprintf(output, ",%.4f", s.win_count[p] / n);
+
+      fprintf(output, ",%.1f,%lu,%.0f,%lu,%lu\n", s.tick_count / n,
+              s.max_tick_count, ticks_per_second(s),
+              s.think_latency.quantile(0.5), s.think_latency.quantile(0.99));
+    }
+}
+
+static void write_json(std::FILE* output,
+                       const std::vector<bim::game::feature_flags>& features,
+                       const std::vector<contest_stats>& stats,
+                       std::uint8_t player_count)
+{
+  fprintf(output, "[");
+
+  for (std::size_t i = 0; i != stats.size(); ++i)
+    {
+      const contest_stats& s = stats[i];
+      const double n = std::max<std::uint32_t>(1, s.contest_count);
+      const std::string label = features_label(features[i], "\", \"");
+
+      fprintf(output,
+              "%s\n  {\n    \"features\": [%s%s%s],\n"
+              "    \"contests\": %u,\n    \"draw_rate\": %.4f,\n"
+              "    \"win_rates\": [",
+              (i == 0) ? "" : ",", label.empty() ? "" : "\"", label.c_str(),
+              label.empty() ? "" : "\"", s.contest_count, s.draw_count / n);
+
+      for (int p = 0; p != player_count; ++p)
+        fprintf(output, "%s%.4f", (p == 0) ? "" : ", ", s.win_count[p] / n);
+
+      fprintf(output,
+              "],\n    \"mean_ticks\": %.1f,\n    \"max_ticks\": %lu,\n"
+              "    \"ticks_per_second\": %.0f,\n"
+              "    \"think_p50_ns\": %lu,\n    \"think_p99_ns\": %lu\n  }",
+              s.tick_count / n, s.max_tick_count, ticks_per_second(s),
+              s.think_latency.quantile(0.5), s.think_latency.quantile(0.99));
+    }
+
+  fprintf(output, "\n]\n");
+}
+
+void run_tournament(std::FILE* output, const tournament_options& options)
+{
+  const std::vector<bim::game::feature_flags> features =
+      feature_combinations(options.features);
+  const std::size_t job_count = features.size() * options.seed_count;
+  const std::size_t thread_count =
+      std::max<std::size_t>(1, std::min(options.thread_count, job_count));
+
+  // The contests have very different durations, thus instead of splitting
+  // the jobs evenly between the threads, each thread takes the next job as
+  // soon as it is available.
+  std::atomic<std::size_t> next_job(0);
+  std::vector<std::vector<contest_stats>> thread_stats(
+      thread_count, std::vector<contest_stats>(features.size()));
+
+  const auto work = [&](std::vector<contest_stats>& stats) -> void
+    {
+      while (true)
+        {
+          const std::size_t job = next_job.fetch_add(1);
+
+          if (job >= job_count)
+            return;
+
+          const std::size_t feature_index = job / options.seed_count;
+
+          play_contest(
+              stats[feature_index],
+              { .seed = options.first_seed + job % options.seed_count,
+                .features = features[feature_index],
+                .player_count = options.player_count,
+                .crate_probability = bim::game::g_default_crate_probability,
+                .arena_width = bim::game::g_default_arena_width,
+                .arena_height = bim::game::g_default_arena_height });
+        }
+    };
+
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count - 1);
+
+  for (std::size_t i = 1; i != thread_count; ++i)
+    threads.emplace_back(work, std::ref(thread_stats[i]));
+
+  work(thread_stats[0]);
+
+  for (std::thread& t : threads)
+    t.join();
+
+  for (std::size_t i = 1; i != thread_count; ++i)
+    for (std::size_t f = 0; f != features.size(); ++f)
+      thread_stats[0][f].merge(thread_stats[i][f]);
+
+  switch (options.format)
+    {
+    case tournament_report_format::csv:
+      write_csv(output, features, thread_stats[0], options.player_count);
+      break;
+    case tournament_report_format::json:
+      write_json(output, features, thread_stats[0], options.player_count);
+      break;
+    }
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/game/feature_flags_fwd.hpp>
+
+#include <cstdint>
+#include <cstdio>
+
+enum class tournament_report_format : std::uint8_t
+{
+  csv,
+  json
+};
+
+struct tournament_options
+{
+  std::uint64_t first_seed;
+  std::uint32_t seed_count;
+  std::uint8_t player_count;
+
+  /// The contests are played with every combination of these features.
+  bim::game::feature_flags features;
+
+  std::size_t thread_count;
+  tournament_report_format format;
+};
+
+/**
+ * Play contests between bots for every seed and every combination of
+ * features, in parallel, then write in the output file the aggregated
+ * statistics for each combination of features.
+ */
+void run_tournament(std::FILE* output, const tournament_options& options);
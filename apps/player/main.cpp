@@ -6,17 +6,24 @@
 #include <bim/game/dump_arena.hpp>
 #include <bim/game/feature_flags.hpp>
 #include <bim/game/feature_flags_string.hpp>
+#include <bim/game/per_player_array.hpp>
+#include <bim/game/player_action.hpp>
+
+#include <bim/net/message/game_update_from_client.hpp>
+#include <bim/net/message/game_update_from_server.hpp>
 
 #include <bim/version.hpp>
 
 #include <iscool/log/enable_console_log.hpp>
 
+#include <algorithm>
 #include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <string_view>
+#include <vector>
 
 static void dump_timeline(const bim::game::contest_timeline& timeline)
 {
@@ -102,13 +109,124 @@ static void dump_timeline(const bim::game::contest_timeline& timeline)
     std::cout << "Everybody lost.\n";
 }
 
+/**
+ * Replay the timeline and print the average size of the game update messages
+ * that would be sent for this game, for various counts of ticks per message.
+ * The sizes with one action per tick, as in the protocol before the actions
+ * were run-length coded, are displayed for comparison.
+ */
+static void dump_update_sizes(const bim::game::contest_timeline& timeline)
+{
+  const bim::game::contest_fingerprint& fingerprint = timeline.fingerprint();
+  bim::game::contest contest(fingerprint);
+
+  // The actions of each player, as long as it is in the game.
+  bim::game::per_player_array<std::vector<bim::game::player_action>> actions;
+
+  for (std::size_t t = 0, n = timeline.tick_count(); t != n; ++t)
+    {
+      timeline.load_tick(t, contest.registry());
+
+      for (int i = 0; i != fingerprint.player_count; ++i)
+        if (const bim::game::player_action* const action =
+                bim::game::find_player_action_by_index(contest.registry(), i))
+          actions[i].push_back(*action);
+
+      if (!contest.tick().still_running())
+        break;
+    }
+
+  // The size of the messages when each action was written in four bits:
+  // three bits for the movement, one bit for the bomb.
+  const auto legacy_size = [](std::size_t header_size,
+                              std::size_t action_count) -> std::size_t
+  {
+    return header_size + (action_count * 4 + 7) / 8;
+  };
+
+  std::cout << "ticks/update, server bytes/update, legacy, "
+               "client bytes/update, legacy\n";
+
+  for (const std::size_t window : { 1, 5, 10, 20, 50 })
+    {
+      std::size_t update_count = 0;
+      std::size_t server_bytes = 0;
+      std::size_t server_legacy_bytes = 0;
+      std::size_t client_update_count = 0;
+      std::size_t client_bytes = 0;
+      std::size_t client_legacy_bytes = 0;
+
+      iscool::net::message message;
+
+      for (std::size_t t = 0, n = timeline.tick_count(); t < n; t += window)
+        {
+          bim::net::game_update_from_server server_update;
+          server_update.from_tick = t;
+          server_update.final_checksum = 0;
+          server_update.player_count = fingerprint.player_count;
+
+          std::size_t action_count = 0;
+
+          for (int i = 0; i != fingerprint.player_count; ++i)
+            {
+              if (t >= actions[i].size())
+                continue;
+
+              const std::vector<bim::game::player_action>::const_iterator
+                  begin = actions[i].begin() + t;
+              const std::vector<bim::game::player_action>::const_iterator
+                  end = actions[i].begin()
+                        + std::min(t + window, actions[i].size());
+
+              server_update.actions[i].assign(begin, end);
+              action_count += end - begin;
+
+              bim::net::game_update_from_client client_update;
+              client_update.checksum_tick = t;
+              client_update.checksum = 0;
+              client_update.from_tick = t;
+              client_update.actions.assign(begin, end);
+
+              client_update.build_message(message);
+              client_bytes += message.get_content().size();
+              client_legacy_bytes += legacy_size(13, end - begin);
+              ++client_update_count;
+            }
+
+          server_update.build_message(message);
+          server_bytes += message.get_content().size();
+          server_legacy_bytes +=
+              legacy_size(9 + fingerprint.player_count, action_count);
+          ++update_count;
+        }
+
+      if (update_count == 0)
+        continue;
+
+      std::cout << window << ", " << (double)server_bytes / update_count
+                << ", " << (double)server_legacy_bytes / update_count << ", "
+                << (double)client_bytes / client_update_count << ", "
+                << (double)client_legacy_bytes / client_update_count << '\n';
+    }
+}
+
 static void usage(std::string_view program_name)
-{}
+{
+  std::cout << "Usage: " << program_name << " [--update-sizes] FILE\n"
+            << "Replay the contest timeline stored in FILE.\n\n"
+            << "Options:\n"
+            << "  --update-sizes  Instead of printing the game, print the "
+               "average size of the\n"
+            << "                  game updates exchanged with the server.\n";
+}
 
 int main(int argc, char* argv[])
 {
   iscool::log::enable_console_log();
 
+  bool update_sizes = false;
+  const char* file_name = nullptr;
+
   for (int i = 1; i != argc; ++i)
     {
       const std::string_view arg = argv[i];
@@ -118,20 +236,25 @@ int main(int argc, char* argv[])
           usage(argv[0]);
           return EXIT_SUCCESS;
         }
+
+      if (arg == "--update-sizes")
+        update_sizes = true;
+      else
+        file_name = argv[i];
     }
 
-  if (argc != 2)
+  if (!file_name)
     {
       std::cerr << "Missing file name. See --help for details.\n";
       return EXIT_FAILURE;
     }
 
   errno = 0;
-  std::FILE* f = std::fopen(argv[1], "r");
+  std::FILE* f = std::fopen(file_name, "r");
 
   if (!f)
     {
-      std::cerr << "Failed to open '" << argv[1] << "':" << strerror(errno)
+      std::cerr << "Failed to open '" << file_name << "':" << strerror(errno)
                 << '\n';
       return EXIT_FAILURE;
     }
@@ -143,7 +266,10 @@ int main(int argc, char* argv[])
 
   std::fclose(f);
 
-  dump_timeline(timeline);
+  if (update_sizes)
+    dump_update_sizes(timeline);
+  else
+    dump_timeline(timeline);
 
   return EXIT_SUCCESS;
 }
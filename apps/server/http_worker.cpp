@@ -6,9 +6,20 @@
 
 #include <curl/curl.h>
 
+#include <algorithm>
 #include <cassert>
+#include <memory>
 #include <utility>
 
+static constexpr std::size_t g_request_queue_capacity = 256;
+static constexpr std::size_t g_result_queue_capacity = 256;
+
+/// How long the worker waits for an activity on the sockets or a new request.
+static constexpr int g_poll_timeout_ms = 1000;
+
+/// How long the worker waits when the result queue is full.
+static constexpr int g_full_result_queue_poll_timeout_ms = 10;
+
 static size_t write_callback(char* ptr, size_t, size_t nmemb, void* userdata)
 {
   std::vector<char>& response =
@@ -19,179 +30,349 @@ static size_t write_callback(char* ptr, size_t, size_t nmemb, void* userdata)
   return nmemb;
 }
 
+http_worker::thread_shared::thread_shared()
+  : request_queue(g_request_queue_capacity)
+  , result_queue(g_result_queue_capacity)
+  , quit(false)
+  , max_connections(1)
+  , multi(nullptr)
+{}
+
+/**
+ * The worker runs up to max_connections requests at once with a CURL multi
+ * handle. The easy handles are kept between the requests, such that the
+ * connections to the servers are reused.
+ */
 class http_worker::thread
 {
 public:
   explicit thread(http_worker::thread_shared& shared)
     : m_thread_shared(shared)
+    , m_multi(static_cast<CURLM*>(shared.multi))
+    , m_running_count(0)
   {}
 
   void operator()()
   {
-    m_curl = curl_easy_init();
+    while (!m_thread_shared.quit)
+      {
+        int running_count;
+        const CURLMcode code = curl_multi_perform(m_multi, &running_count);
+
+        if (code != CURLM_OK)
+          ic_log(iscool::log::nature::error(), "http_worker",
+                 "curl_multi_perform() failed: {}.",
+                 curl_multi_strerror(code));
+
+        collect_results();
+
+        // Start the pending requests in the connections released by the
+        // completed ones. The poll below returns immediately for the new
+        // transfers, as CURL has work to do for them.
+        start_requests();
+
+        // Wait for some activity on the sockets. The main thread interrupts
+        // the wait when it pushes a request or when we have to quit.
+        const int timeout_ms = m_results.empty()
+                                   ? g_poll_timeout_ms
+                                   : g_full_result_queue_poll_timeout_ms;
+        curl_multi_poll(m_multi, nullptr, 0, timeout_ms, nullptr);
+      }
 
-    if (!m_curl)
+    for (const std::unique_ptr<transfer>& t : m_transfers)
       {
-        ic_log(iscool::log::nature::error(), "http_worker",
-               "Failed to create CURL handle.");
-        return;
+        if (t->running)
+          curl_multi_remove_handle(m_multi, t->handle);
+
+        release_headers(*t);
+        curl_easy_cleanup(t->handle);
       }
+  }
 
-    while (true)
+private:
+  struct transfer
+  {
+    CURL* handle;
+    curl_slist* headers;
+    iscool::http::request request;
+    std::vector<char> response_data;
+    bool running;
+  };
+
+private:
+  void start_requests()
+  {
+    while (m_running_count < m_thread_shared.max_connections)
       {
-        std::unique_lock lock(m_thread_shared.in_mutex);
+        transfer* const t = idle_transfer();
 
-        m_thread_shared.data_available.wait(
-            lock,
-            [this]()
-              {
-                return m_thread_shared.quit
-                       || !m_thread_shared.request_queue.empty();
-              });
+        if (!t)
+          return;
 
-        if (m_thread_shared.quit)
+        if (!m_thread_shared.request_queue.pop(t->request))
           return;
 
-        iscool::http::request request =
-            std::move(m_thread_shared.request_queue[0]);
-        m_thread_shared.request_queue.erase(
-            m_thread_shared.request_queue.begin());
+        start_request(*t);
+      }
+  }
+
+  transfer* idle_transfer()
+  {
+    const std::vector<std::unique_ptr<transfer>>::iterator it =
+        std::find_if(m_transfers.begin(), m_transfers.end(),
+                     [](const std::unique_ptr<transfer>& t) -> bool
+                       {
+                         return !t->running;
+                       });
+
+    if (it != m_transfers.end())
+      return it->get();
 
-        lock.unlock();
-        process_request(std::move(request));
+    CURL* const handle = curl_easy_init();
+
+    if (!handle)
+      {
+        ic_log(iscool::log::nature::error(), "http_worker",
+               "Failed to create CURL handle.");
+        return nullptr;
       }
 
-    curl_easy_cleanup(m_curl);
+    m_transfers.emplace_back(new transfer{ .handle = handle,
+                                           .headers = nullptr,
+                                           .request = {},
+                                           .response_data = {},
+                                           .running = false });
+
+    return m_transfers.back().get();
   }
 
-private:
-  void process_request(iscool::http::request request)
+  void start_request(transfer& t)
   {
-    std::vector<char> response_data;
-    curl_slist* headers = nullptr;
+    // The reset keeps the connections and the DNS cache of the handle.
+    curl_easy_reset(t.handle);
+    t.response_data.clear();
 
-    auto queue_result = [&, this](int response_code)
+    if (!configure(t))
       {
-        if (headers)
-          curl_slist_free_all(headers);
+        queue_result(t, 0);
+        return;
+      }
 
-        const std::lock_guard lock(m_thread_shared.out_mutex);
-        m_thread_shared.result_queue.emplace_back(
-            std::move(request.result_handler), std::move(response_data),
-            response_code);
-      };
+    const CURLMcode code = curl_multi_add_handle(m_multi, t.handle);
 
-    curl_easy_reset(m_curl);
+    if (code != CURLM_OK)
+      {
+        ic_log(iscool::log::nature::error(), "http_worker",
+               "Failed to start the request to {}: {}", t.request.url,
+               curl_multi_strerror(code));
+        queue_result(t, 0);
+        return;
+      }
 
+    t.running = true;
+    ++m_running_count;
+  }
+
+  bool configure(transfer& t)
+  {
     CURLcode result =
-        curl_easy_setopt(m_curl, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(t.handle, CURLOPT_URL, t.request.url.c_str());
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
-               "Failed to set URL {}: {}", request.url,
+               "Failed to set URL {}: {}", t.request.url,
                curl_easy_strerror(result));
-        return queue_result(0);
+        return false;
       }
 
-    result = curl_easy_setopt(m_curl, CURLOPT_REDIR_PROTOCOLS_STR, "https");
+    result = curl_easy_setopt(t.handle, CURLOPT_REDIR_PROTOCOLS_STR, "https");
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
                "Failed to set redirect protocols: {}",
                curl_easy_strerror(result));
-        return queue_result(0);
+        return false;
       }
 
-    result = curl_easy_setopt(m_curl, CURLOPT_FOLLOWLOCATION, CURLFOLLOW_ALL);
+    result =
+        curl_easy_setopt(t.handle, CURLOPT_FOLLOWLOCATION, CURLFOLLOW_ALL);
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
                "Failed to enable redirect: {}", curl_easy_strerror(result));
-        return queue_result(0);
+        return false;
       }
 
-    for (const std::string& header : request.headers)
-      headers = curl_slist_append(headers, header.c_str());
+    for (const std::string& header : t.request.headers)
+      t.headers = curl_slist_append(t.headers, header.c_str());
 
-    if (headers)
+    if (t.headers)
       {
-        result = curl_easy_setopt(m_curl, CURLOPT_HTTPHEADER, headers);
+        result = curl_easy_setopt(t.handle, CURLOPT_HTTPHEADER, t.headers);
 
         if (result != CURLE_OK)
           {
             ic_log(iscool::log::nature::error(), "http_thread",
                    "Failed to set HTTP headers: {}",
                    curl_easy_strerror(result));
-            return queue_result(0);
+            return false;
           }
       }
 
-    if (request.request_type == iscool::http::request::type::post)
+    if (t.request.request_type == iscool::http::request::type::post)
       {
-        result =
-            curl_easy_setopt(m_curl, CURLOPT_POSTFIELDS, request.body.c_str());
+        // The body is not copied by CURL, it remains valid in the transfer
+        // until the request is complete.
+        result = curl_easy_setopt(t.handle, CURLOPT_POSTFIELDS,
+                                  t.request.body.c_str());
 
         if (result != CURLE_OK)
           {
             ic_log(iscool::log::nature::error(), "http_thread",
                    "Failed to set POST fields: {}",
                    curl_easy_strerror(result));
-            return queue_result(0);
+            return false;
           }
       }
 
-    response_data.reserve(512);
-    result = curl_easy_setopt(m_curl, CURLOPT_WRITEDATA, &response_data);
+    t.response_data.reserve(512);
+    result = curl_easy_setopt(t.handle, CURLOPT_WRITEDATA, &t.response_data);
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
                "Failed to pass write data: {}", curl_easy_strerror(result));
-        return queue_result(0);
+        return false;
       }
 
-    result = curl_easy_setopt(m_curl, CURLOPT_WRITEFUNCTION, write_callback);
+    result = curl_easy_setopt(t.handle, CURLOPT_WRITEFUNCTION, write_callback);
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
                "Failed to pass write callback: {}",
                curl_easy_strerror(result));
-        return queue_result(0);
+        return false;
       }
 
-    result = curl_easy_perform(m_curl);
+    result = curl_easy_setopt(t.handle, CURLOPT_PRIVATE, &t);
 
     if (result != CURLE_OK)
       {
         ic_log(iscool::log::nature::error(), "http_thread",
-               "curl_easy_perform() failed: {}", curl_easy_strerror(result));
-        return queue_result(0);
+               "Failed to attach the transfer: {}",
+               curl_easy_strerror(result));
+        return false;
       }
 
-    long response_code;
-    result = curl_easy_getinfo(m_curl, CURLINFO_RESPONSE_CODE, &response_code);
+    return true;
+  }
 
-    if (result != CURLE_OK)
+  void collect_results()
+  {
+    int remaining;
+
+    while (const CURLMsg* const message =
+               curl_multi_info_read(m_multi, &remaining))
       {
-        ic_log(iscool::log::nature::error(), "http_thread",
-               "Failed to get response code: {}", curl_easy_strerror(result));
-        return queue_result(0);
+        if (message->msg != CURLMSG_DONE)
+          continue;
+
+        CURL* const handle = message->easy_handle;
+        const CURLcode code = message->data.result;
+
+        char* p;
+        curl_easy_getinfo(handle, CURLINFO_PRIVATE, &p);
+        transfer* const t = reinterpret_cast<transfer*>(p);
+
+        curl_multi_remove_handle(m_multi, handle);
+        t->running = false;
+        --m_running_count;
+
+        if (code != CURLE_OK)
+          {
+            ic_log(iscool::log::nature::error(), "http_thread",
+                   "Request to {} failed: {}", t->request.url,
+                   curl_easy_strerror(code));
+            queue_result(*t, 0);
+            continue;
+          }
+
+        long response_code;
+        const CURLcode result =
+            curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response_code);
+
+        if (result != CURLE_OK)
+          {
+            ic_log(iscool::log::nature::error(), "http_thread",
+                   "Failed to get response code: {}",
+                   curl_easy_strerror(result));
+            queue_result(*t, 0);
+            continue;
+          }
+
+        queue_result(*t, response_code);
       }
 
-    queue_result(response_code);
+    flush_results();
+  }
+
+  void queue_result(transfer& t, int response_code)
+  {
+    release_headers(t);
+
+    m_results.emplace_back(std::move(t.request.result_handler),
+                           std::move(t.response_data), response_code);
+    t.request = iscool::http::request();
+  }
+
+  void flush_results()
+  {
+    if (m_results.empty())
+      return;
+
+    // The results that do not fit in the queue are kept for the next
+    // iteration.
+    std::size_t count = 0;
+
+    while ((count != m_results.size())
+           && m_thread_shared.result_queue.push(m_results[count]))
+      ++count;
+
+    m_results.erase(m_results.begin(), m_results.begin() + count);
+
+    if (count != 0)
+      m_thread_shared.result_ready();
+  }
+
+  static void release_headers(transfer& t)
+  {
+    if (t.headers)
+      {
+        curl_slist_free_all(t.headers);
+        t.headers = nullptr;
+      }
   }
 
 private:
   http_worker::thread_shared& m_thread_shared;
-  CURL* m_curl;
+  CURLM* const m_multi;
+
+  std::vector<std::unique_ptr<transfer>> m_transfers;
+  std::size_t m_running_count;
+
+  std::vector<http_worker::result> m_results;
 };
 
-http_worker::http_worker()
+http_worker::http_worker(std::function<void()> result_ready,
+                         std::size_t max_connections)
 {
+  m_thread_shared.result_ready = std::move(result_ready);
+  m_thread_shared.max_connections = std::max<std::size_t>(1, max_connections);
+
   const CURLcode result = curl_global_init(CURL_GLOBAL_ALL);
 
   if (result != CURLE_OK)
@@ -201,48 +382,76 @@ http_worker::http_worker()
       return;
     }
 
-  m_thread_shared.quit = false;
-  m_thread_shared.request_queue.reserve(8);
+  CURLM* const multi = curl_multi_init();
+
+  if (!multi)
+    {
+      ic_log(iscool::log::nature::error(), "http_worker",
+             "Failed to create CURL multi handle.");
+      return;
+    }
+
+  // Keep one connection per concurrent request alive, for reuse by the next
+  // requests.
+  curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS,
+                    (long)m_thread_shared.max_connections);
+  curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS,
+                    (long)m_thread_shared.max_connections);
+
+  m_thread_shared.multi = multi;
+  m_pending_requests.reserve(8);
   m_thread = std::thread(thread(m_thread_shared));
 }
 
 http_worker::~http_worker()
 {
-  {
-    const std::lock_guard lock(m_thread_shared.in_mutex);
-    m_thread_shared.quit = true;
-    m_thread_shared.request_queue.clear();
-  }
+  m_thread_shared.quit = true;
 
-  m_thread_shared.data_available.notify_all();
+  if (m_thread_shared.multi)
+    curl_multi_wakeup(static_cast<CURLM*>(m_thread_shared.multi));
 
   if (m_thread.joinable())
     m_thread.join();
 
+  if (m_thread_shared.multi)
+    curl_multi_cleanup(static_cast<CURLM*>(m_thread_shared.multi));
+
   curl_global_cleanup();
 }
 
 void http_worker::push(iscool::http::request request)
 {
-  {
-    const std::lock_guard lock(m_thread_shared.in_mutex);
-    m_thread_shared.request_queue.push_back(std::move(request));
-  }
-
-  m_thread_shared.data_available.notify_one();
+  m_pending_requests.push_back(std::move(request));
+  flush_requests();
 }
 
 void http_worker::dispatch_responses()
 {
-  assert(m_result_queue.empty());
+  m_thread_shared.result_queue.consume_all(
+      [](const result& r) -> void
+        {
+          r.response_handler(iscool::http::response(r.status, r.data));
+        });
 
-  {
-    const std::lock_guard lock(m_thread_shared.out_mutex);
-    m_result_queue.swap(m_thread_shared.result_queue);
-  }
+  flush_requests();
+}
+
+void http_worker::flush_requests()
+{
+  if (m_pending_requests.empty() || !m_thread_shared.multi)
+    return;
+
+  // The requests are kept in order: none is pushed in the queue until the
+  // previous ones are in it.
+  std::size_t count = 0;
+
+  while ((count != m_pending_requests.size())
+         && m_thread_shared.request_queue.push(m_pending_requests[count]))
+    ++count;
 
-  for (const result& r : m_result_queue)
-    r.response_handler(iscool::http::response(r.status, r.data));
+  m_pending_requests.erase(m_pending_requests.begin(),
+                           m_pending_requests.begin() + count);
 
-  m_result_queue.clear();
+  if (count != 0)
+    curl_multi_wakeup(static_cast<CURLM*>(m_thread_shared.multi));
 }
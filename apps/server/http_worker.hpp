@@ -3,18 +3,31 @@
 
 #include <iscool/http/request.hpp>
 
-#include <condition_variable>
-#include <mutex>
+#include <boost/lockfree/spsc_queue.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <thread>
 #include <vector>
 
 class http_worker
 {
 public:
-  http_worker();
+  /**
+   * \param result_ready Called from the worker thread when a response is
+   *        available for dispatch_responses().
+   * \param max_connections How many requests can be processed concurrently.
+   */
+  http_worker(std::function<void()> result_ready,
+              std::size_t max_connections);
   ~http_worker();
 
+  /// Queue a request for the worker. Must be called from the main thread.
   void push(iscool::http::request request);
+
+  /// Call the handlers of the completed requests and send the requests that
+  /// did not fit in the queue. Must be called from the main thread.
   void dispatch_responses();
 
 private:
@@ -27,19 +40,31 @@ private:
 
   struct thread_shared
   {
-    std::vector<iscool::http::request> request_queue;
-    bool quit;
-    std::mutex in_mutex;
-    std::condition_variable data_available;
+    thread_shared();
+
+    /// Produced by the main thread, consumed by the worker.
+    boost::lockfree::spsc_queue<iscool::http::request> request_queue;
+
+    /// Produced by the worker, consumed by the main thread.
+    boost::lockfree::spsc_queue<result> result_queue;
 
-    std::mutex out_mutex;
-    std::vector<result> result_queue;
+    std::atomic<bool> quit;
+    std::function<void()> result_ready;
+    std::size_t max_connections;
+
+    /// The CURL multi handle of the worker, used to wake it up.
+    void* multi;
   };
 
   class thread;
 
+private:
+  void flush_requests();
+
 private:
   thread_shared m_thread_shared;
   std::thread m_thread;
-  std::vector<result> m_result_queue;
+
+  /// The requests that did not fit in the queue, sent on the next dispatch.
+  std::vector<iscool::http::request> m_pending_requests;
 };
@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #include "http_worker.hpp"
+#include "wake_up_signal.hpp"
 
 #include <bim/server/config.hpp>
 #include <bim/server/server.hpp>
@@ -39,7 +40,6 @@
 #include <stdexcept>
 #include <string_view>
 #include <sys/wait.h>
-#include <thread>
 #include <unistd.h>
 
 static bool g_keep_running = true;
@@ -287,6 +287,9 @@ static command_line parse_command_line(int argc, char* argv[])
       boost::program_options::value<std::int64_t>(),
       "How long to wait between two registration attempts when we can't get "
       "the delay from the business server.");
+  config_options.add_options()(
+      "http-max-connections", boost::program_options::value<std::uint16_t>(),
+      "How many HTTP requests can be processed concurrently.");
   all_options.add(config_options);
 
   boost::program_options::options_description statistics_options(
@@ -475,6 +478,15 @@ static command_line parse_command_line(int argc, char* argv[])
   game_options.add_options()("game-service-enable-checksum-validation",
                              "Should we check the checksum of the game state "
                              "against the checksum sent by the clients.");
+  game_options.add_options()(
+      "game-service-shard-count",
+      boost::program_options::value<std::uint16_t>(),
+      "How many worker threads run the game simulations. Zero to run them in "
+      "the main thread.");
+  game_options.add_options()(
+      "game-service-enable-system-timings",
+      "Measure the execution time of each system of the games, and report it "
+      "in the statistics.");
 
   game_options.add_options()(
       "enable-contest-timeline-recording",
@@ -570,6 +582,7 @@ static command_line parse_command_line(int argc, char* argv[])
   parse_config_option(business_url);
   parse_config_option(business_token);
   parse_config_option(business_registration_pulse_seconds);
+  parse_config_option(http_max_connections);
   parse_config_option(enable_bots);
   parse_config_option(matchmaking_clean_up_interval);
   parse_config_option(matchmaking_delay_for_bot);
@@ -590,6 +603,9 @@ static command_line parse_command_line(int argc, char* argv[])
   parse_config_option(game_service_coins_per_short_game_draw);
 
   parse_config_option(game_service_enable_checksum_validation);
+  parse_config_option(game_service_shard_count);
+  parse_config_option(game_service_enable_system_timings);
+  parse_config_option(game_service_bot_think_budget);
 
   parse_config_option(enable_contest_timeline_recording);
 
@@ -691,10 +707,40 @@ int main(int argc, char* argv[])
   if (command_line.options->testing_throw)
     force_throw();
 
+  using clock = wake_up_signal::clock;
+
+  // The main loop sleeps until there is something to do. The scheduler wakes
+  // it up when a call is scheduled, from any thread (e.g. the socket thread
+  // when a message is received, or the game shards when they have messages to
+  // send), and the HTTP worker wakes it up when a response is available.
+  wake_up_signal wake_up;
+
   iscool::schedule::manual_scheduler scheduler;
-  iscool::schedule::initialize(scheduler.get_delayed_call_delegate());
+  iscool::schedule::initialize(
+      [&wake_up, delegate = scheduler.get_delayed_call_delegate()](
+          auto&& f, auto delay) -> void
+        {
+          delegate(std::forward<decltype(f)>(f), delay);
+
+          // The scheduler is updated with whole milliseconds, so it may be
+          // up to one millisecond late on the wall clock. We add this
+          // millisecond to the date to be sure that the call is due when we
+          // wake up.
+          if (delay.count() == 0)
+            wake_up.notify();
+          else
+            wake_up.notify_at(clock::now()
+                              + std::chrono::duration_cast<clock::duration>(
+                                  delay)
+                              + std::chrono::milliseconds(1));
+        });
 
-  http_worker http;
+  http_worker http(
+      [&wake_up]() -> void
+        {
+          wake_up.notify();
+        },
+      command_line.options->config.http_max_connections);
   iscool::http::initialize(
       [&http](const iscool::http::request& request)
         {
@@ -708,11 +754,12 @@ int main(int argc, char* argv[])
 
   const bim::server::server server(command_line.options->config);
 
-  using clock = std::chrono::steady_clock;
-
   std::chrono::nanoseconds slice_duration(0);
   clock::time_point last_update = clock::now();
 
+  // The maximum duration of an iteration of the loop before we consider that
+  // the server is overloaded. This is also the maximum sleep duration, such
+  // that we check g_keep_running regularly.
   constexpr std::chrono::milliseconds tick_interval(10);
 
   while (g_keep_running)
@@ -721,17 +768,14 @@ int main(int argc, char* argv[])
       slice_duration += start - last_update;
       last_update = start;
 
-      if (slice_duration >= std::chrono::milliseconds(1))
-        {
-          http.dispatch_responses();
+      http.dispatch_responses();
 
-          const std::chrono::milliseconds update_ms =
-              std::chrono::duration_cast<std::chrono::milliseconds>(
-                  slice_duration);
+      const std::chrono::milliseconds update_ms =
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              slice_duration);
 
-          slice_duration -= update_ms;
-          scheduler.update_interval(update_ms);
-        }
+      slice_duration -= update_ms;
+      scheduler.update_interval(update_ms);
 
       FrameMark;
 
@@ -739,21 +783,18 @@ int main(int argc, char* argv[])
       const std::chrono::milliseconds tick_duration =
           std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-      if (tick_duration < tick_interval)
-        {
-          if (tick_interval - tick_duration <= 20 * tick_interval / 100)
-            ic_log(iscool::log::nature::info(), "server",
-                   "Stressed. Tick took {} of {} ({}%).", tick_duration,
-                   tick_interval,
-                   (int)(tick_duration.count() * 100) / tick_interval.count());
-
-          std::this_thread::sleep_for(tick_interval - (end - start));
-        }
-      else
+      if (tick_duration >= tick_interval)
         ic_log(iscool::log::nature::info(), "server",
                "Overloaded. Tick took {} but should be under {} ({}%).",
                tick_duration, tick_interval,
                (int)(tick_duration.count() * 100) / tick_interval.count());
+      else if (tick_interval - tick_duration <= 20 * tick_interval / 100)
+        ic_log(iscool::log::nature::info(), "server",
+               "Stressed. Tick took {} of {} ({}%).", tick_duration,
+               tick_interval,
+               (int)(tick_duration.count() * 100) / tick_interval.count());
+
+      wake_up.wait(end + tick_interval);
     }
 
   ic_log(iscool::log::nature::info(), "server", "Quit.");
@@ -0,0 +1,317 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include "http_worker.hpp"
+
+#include <iscool/http/request.hpp>
+#include <iscool/log/setup.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+  /**
+   * A minimal HTTP server on the loopback interface, answering each request
+   * in its own thread. The requests to /slow are answered only after the
+   * call to release_slow_requests().
+   */
+  class local_http_server
+  {
+  public:
+    local_http_server();
+    ~local_http_server();
+
+    std::string url(std::string_view path) const;
+    std::size_t served_count() const;
+    void release_slow_requests();
+
+  private:
+    void accept_connections();
+    void serve(int fd);
+
+  private:
+    int m_socket;
+    std::uint16_t m_port;
+
+    std::atomic<bool> m_quit;
+    std::atomic<bool> m_slow_released;
+    std::atomic<std::size_t> m_served_count;
+
+    std::mutex m_mutex;
+    std::vector<std::thread> m_connections;
+    std::thread m_thread;
+  };
+}
+
+local_http_server::local_http_server()
+  : m_socket(socket(AF_INET, SOCK_STREAM, 0))
+  , m_port(0)
+  , m_quit(false)
+  , m_slow_released(false)
+  , m_served_count(0)
+{
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+
+  socklen_t length = sizeof(address);
+
+  // Let the system pick a free port.
+  if ((bind(m_socket, (sockaddr*)&address, sizeof(address)) != 0)
+      || (listen(m_socket, 64) != 0)
+      || (getsockname(m_socket, (sockaddr*)&address, &length) != 0))
+    return;
+
+  m_port = ntohs(address.sin_port);
+  m_thread = std::thread(&local_http_server::accept_connections, this);
+}
+
+local_http_server::~local_http_server()
+{
+  m_quit = true;
+
+  if (m_thread.joinable())
+    m_thread.join();
+
+  for (std::thread& t : m_connections)
+    t.join();
+
+  close(m_socket);
+}
+
+std::string local_http_server::url(std::string_view path) const
+{
+  return "http://127.0.0.1:" + std::to_string(m_port) + std::string(path);
+}
+
+std::size_t local_http_server::served_count() const
+{
+  return m_served_count;
+}
+
+void local_http_server::release_slow_requests()
+{
+  m_slow_released = true;
+}
+
+void local_http_server::accept_connections()
+{
+  pollfd p{ .fd = m_socket, .events = POLLIN, .revents = 0 };
+
+  while (!m_quit)
+    {
+      // Poll with a timeout to check m_quit regularly.
+      if (poll(&p, 1, 10) <= 0)
+        continue;
+
+      const int fd = accept(m_socket, nullptr, nullptr);
+
+      if (fd < 0)
+        continue;
+
+      const std::unique_lock<std::mutex> lock(m_mutex);
+      m_connections.emplace_back(&local_http_server::serve, this, fd);
+    }
+}
+
+void local_http_server::serve(int fd)
+{
+  std::string request;
+  char buffer[1024];
+
+  while (request.find("\r\n\r\n") == std::string::npos)
+    {
+      const ssize_t n = read(fd, buffer, sizeof(buffer));
+
+      if (n <= 0)
+        {
+          close(fd);
+          return;
+        }
+
+      request.append(buffer, n);
+    }
+
+  // The request line is "GET <path> HTTP/1.1".
+  const std::size_t path_begin = request.find(' ') + 1;
+  const std::string_view path(request.data() + path_begin,
+                              request.find(' ', path_begin) - path_begin);
+
+  if (path == "/slow")
+    while (!m_slow_released && !m_quit)
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  constexpr std::string_view response = "HTTP/1.1 200 OK\r\n"
+                                        "Content-Length: 2\r\n"
+                                        "Connection: close\r\n"
+                                        "\r\n"
+                                        "ok";
+
+  const ssize_t n = write(fd, response.data(), response.size());
+  (void)n;
+
+  ++m_served_count;
+  close(fd);
+}
+
+/// Wait until ready() returns true, or until a long delay has passed.
+static bool wait_until(const std::function<bool()>& ready)
+{
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+  while (!ready())
+    {
+      if (std::chrono::steady_clock::now() >= deadline)
+        return false;
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+  return true;
+}
+
+/**
+ * Call http_worker::dispatch_responses() until ready() returns true, or until
+ * a long delay has passed.
+ */
+static bool dispatch_until(http_worker& worker,
+                           const std::function<bool()>& ready)
+{
+  return wait_until(
+      [&]() -> bool
+        {
+          worker.dispatch_responses();
+          return ready();
+        });
+}
+
+static iscool::http::request
+new_request(const local_http_server& server, const std::string& path,
+            std::vector<std::string>& completed)
+{
+  iscool::http::request result;
+  result.url = server.url(path);
+  result.request_type = iscool::http::request::type::get;
+  result.result_handler =
+      [&completed, path](const iscool::http::response&) -> void
+        {
+          completed.push_back(path);
+        };
+
+  return result;
+}
+
+TEST(http_worker, slow_request_does_not_block_the_others)
+{
+  const iscool::log::scoped_initializer log;
+  local_http_server server;
+
+  std::atomic<int> result_ready_count(0);
+  http_worker worker(
+      [&result_ready_count]() -> void
+        {
+          ++result_ready_count;
+        },
+      2);
+
+  std::vector<std::string> completed;
+  constexpr std::size_t fast_count = 8;
+
+  worker.push(new_request(server, "/slow", completed));
+
+  for (std::size_t i = 0; i != fast_count; ++i)
+    worker.push(
+        new_request(server, "/fast/" + std::to_string(i), completed));
+
+  // The fast requests go through the second connection while the first one
+  // waits for the slow request.
+  EXPECT_TRUE(dispatch_until(worker,
+                             [&]() -> bool
+                               {
+                                 return completed.size() == fast_count;
+                               }));
+  EXPECT_EQ(completed.end(),
+            std::find(completed.begin(), completed.end(), "/slow"));
+  EXPECT_NE(0, result_ready_count.load());
+
+  server.release_slow_requests();
+
+  EXPECT_TRUE(dispatch_until(worker,
+                             [&]() -> bool
+                               {
+                                 return completed.size() == fast_count + 1;
+                               }));
+  ASSERT_FALSE(completed.empty());
+  EXPECT_EQ("/slow", completed.back());
+}
+
+TEST(http_worker, results_overflowing_the_queue_are_delivered)
+{
+  const iscool::log::scoped_initializer log;
+  local_http_server server;
+
+  std::atomic<int> result_ready_count(0);
+  http_worker worker(
+      [&result_ready_count]() -> void
+        {
+          ++result_ready_count;
+        },
+      4);
+
+  std::vector<std::string> completed;
+
+  // The capacity of the queues of the worker.
+  constexpr std::size_t queue_capacity = 256;
+  constexpr std::size_t overflow_count = 16;
+  constexpr std::size_t total_count = queue_capacity + overflow_count;
+
+  for (std::size_t i = 0; i != queue_capacity; ++i)
+    worker.push(new_request(server, "/first", completed));
+
+  // The results are not dispatched, so they fill the result queue.
+  ASSERT_TRUE(wait_until(
+      [&]() -> bool
+        {
+          return server.served_count() == queue_capacity;
+        }));
+
+  // These results do not fit in the queue.
+  for (std::size_t i = 0; i != overflow_count; ++i)
+    worker.push(new_request(server, "/overflow", completed));
+
+  ASSERT_TRUE(wait_until(
+      [&]() -> bool
+        {
+          return server.served_count() == total_count;
+        }));
+
+  // No request is pushed from now on, so the worker must deliver the
+  // remaining results by itself once there is some room in the queue.
+  const int ready_count_before_dispatch = result_ready_count.load();
+
+  EXPECT_TRUE(dispatch_until(worker,
+                             [&]() -> bool
+                               {
+                                 return completed.size() == total_count;
+                               }));
+  EXPECT_EQ(overflow_count, (std::size_t)std::count(
+                                completed.begin(), completed.end(),
+                                "/overflow"));
+  EXPECT_LT(ready_count_before_dispatch, result_ready_count.load());
+}
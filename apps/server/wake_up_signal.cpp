@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include "wake_up_signal.hpp"
+
+wake_up_signal::wake_up_signal()
+  : m_notified(false)
+{}
+
+wake_up_signal::~wake_up_signal() = default;
+
+void wake_up_signal::notify()
+{
+  {
+    const std::lock_guard lock(m_mutex);
+    m_notified = true;
+  }
+
+  m_condition.notify_one();
+}
+
+void wake_up_signal::notify_at(clock::time_point date)
+{
+  bool earliest;
+
+  {
+    const std::lock_guard lock(m_mutex);
+    earliest = m_dates.empty() || (date < m_dates.top());
+    m_dates.push(date);
+  }
+
+  // The waiting thread must recompute its deadline if this date comes first.
+  if (earliest)
+    m_condition.notify_one();
+}
+
+void wake_up_signal::wait(clock::time_point max_date)
+{
+  std::unique_lock lock(m_mutex);
+
+  while (!m_notified)
+    {
+      const clock::time_point now = clock::now();
+
+      while (!m_dates.empty() && (m_dates.top() <= now))
+        {
+          m_dates.pop();
+          m_notified = true;
+        }
+
+      if (m_notified || (now >= max_date))
+        break;
+
+      const clock::time_point until =
+          m_dates.empty() ? max_date : std::min(max_date, m_dates.top());
+
+      m_condition.wait_until(lock, until);
+    }
+
+  m_notified = false;
+}
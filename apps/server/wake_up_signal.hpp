@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+/**
+ * Blocks the main loop until there is something to do: either an event has
+ * been signaled from any thread, or a scheduled date has been reached.
+ */
+class wake_up_signal
+{
+public:
+  using clock = std::chrono::steady_clock;
+
+public:
+  wake_up_signal();
+  ~wake_up_signal();
+
+  /// Wake up the waiting thread now.
+  void notify();
+
+  /// Wake up the waiting thread at the given date.
+  void notify_at(clock::time_point date);
+
+  /**
+   * Block until notify() is called, or until a date passed to notify_at() is
+   * reached, but not after max_date.
+   */
+  void wait(clock::time_point max_date);
+
+private:
+  using date_heap =
+      std::priority_queue<clock::time_point, std::vector<clock::time_point>,
+                          std::greater<clock::time_point>>;
+
+private:
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  date_heap m_dates;
+  bool m_notified;
+};
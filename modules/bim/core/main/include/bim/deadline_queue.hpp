@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace bim
+{
+  /**
+   * A min-heap of keys ordered by the date at which they expire, to find the
+   * expired entries of a container without scanning it.
+   *
+   * The deadlines are checked lazily: the owner of the keys can postpone the
+   * deadline of a key in its own container without touching the queue. When
+   * the queued date is reached, the owner is asked for the actual deadline of
+   * the key and the key is queued again if it is not reached yet.
+   */
+  template <typename Key>
+  class deadline_queue
+  {
+  public:
+    deadline_queue();
+    ~deadline_queue();
+
+    std::size_t size() const;
+    bool empty() const;
+
+    void reserve(std::size_t n);
+
+    void push(const Key& key, std::chrono::nanoseconds date);
+
+    /**
+     * Remove the keys queued for a date before or at the given date. For each
+     * of them, f(key) is called and must return the actual deadline of the
+     * key, as an std::optional<std::chrono::nanoseconds>. If this deadline is
+     * after the given date then the key is queued again for this deadline,
+     * otherwise it is dropped, and f is expected to have released it.
+     */
+    template <typename F>
+    void pop_expired(std::chrono::nanoseconds date, F&& f);
+
+    void clear();
+
+  private:
+    struct entry
+    {
+      std::chrono::nanoseconds date;
+      Key key;
+    };
+
+  private:
+    static bool later(const entry& a, const entry& b);
+
+  private:
+    std::vector<entry> m_entries;
+  };
+}
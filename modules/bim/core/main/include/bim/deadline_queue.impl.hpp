@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/deadline_queue.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+template <typename Key>
+bim::deadline_queue<Key>::deadline_queue() = default;
+
+template <typename Key>
+bim::deadline_queue<Key>::~deadline_queue() = default;
+
+template <typename Key>
+std::size_t bim::deadline_queue<Key>::size() const
+{
+  return m_entries.size();
+}
+
+template <typename Key>
+bool bim::deadline_queue<Key>::empty() const
+{
+  return m_entries.empty();
+}
+
+template <typename Key>
+void bim::deadline_queue<Key>::reserve(std::size_t n)
+{
+  m_entries.reserve(n);
+}
+
+template <typename Key>
+void bim::deadline_queue<Key>::push(const Key& key,
+                                    std::chrono::nanoseconds date)
+{
+  m_entries.push_back(entry{ .date = date, .key = key });
+  std::push_heap(m_entries.begin(), m_entries.end(), &later);
+}
+
+template <typename Key>
+template <typename F>
+void bim::deadline_queue<Key>::pop_expired(std::chrono::nanoseconds date,
+                                           F&& f)
+{
+  while (!m_entries.empty() && (m_entries.front().date <= date))
+    {
+      std::pop_heap(m_entries.begin(), m_entries.end(), &later);
+
+      const std::optional<std::chrono::nanoseconds> deadline =
+          f(std::as_const(m_entries.back().key));
+
+      if (deadline && (*deadline > date))
+        {
+          m_entries.back().date = *deadline;
+          std::push_heap(m_entries.begin(), m_entries.end(), &later);
+        }
+      else
+        m_entries.pop_back();
+    }
+}
+
+template <typename Key>
+void bim::deadline_queue<Key>::clear()
+{
+  m_entries.clear();
+}
+
+template <typename Key>
+bool bim::deadline_queue<Key>::later(const entry& a, const entry& b)
+{
+  return a.date > b.date;
+}
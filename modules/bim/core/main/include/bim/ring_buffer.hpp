@@ -0,0 +1,68 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace bim
+{
+  /**
+   * A queue stored in a circular buffer, with constant time insertions at
+   * the back and removals from the front. The capacity is a power of two and
+   * doubles when the buffer is full.
+   */
+  template <typename T>
+  class ring_buffer
+  {
+  public:
+    ring_buffer();
+    ~ring_buffer();
+
+    ring_buffer(const ring_buffer<T>& that);
+    ring_buffer(ring_buffer<T>&& that) noexcept;
+
+    ring_buffer& operator=(const ring_buffer<T>& that);
+    ring_buffer& operator=(ring_buffer<T>&& that) noexcept;
+
+    std::size_t size() const;
+    bool empty() const;
+    std::size_t capacity() const;
+
+    void reserve(std::size_t n);
+
+    /// Access the i-th element, counting from the front.
+    T& operator[](std::size_t i);
+    const T& operator[](std::size_t i) const;
+
+    void push_back(const T& value);
+
+    template <typename Iterator>
+    void append(Iterator first, Iterator last);
+
+    /// Remove the first n elements.
+    void pop_front(std::size_t n);
+
+    void clear();
+
+    /**
+     * The elements in [i, i + n), as two contiguous ranges. The second range
+     * is empty unless the elements wrap around the end of the storage.
+     */
+    std::array<std::span<const T>, 2> range(std::size_t i,
+                                            std::size_t n) const;
+
+  private:
+    std::size_t index(std::size_t i) const;
+
+  private:
+    /// The storage, whose size is the capacity of the buffer.
+    std::vector<T> m_data;
+
+    /// Index in m_data of the front element.
+    std::size_t m_first;
+
+    std::size_t m_size;
+  };
+}
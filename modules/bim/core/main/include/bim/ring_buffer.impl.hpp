@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/ring_buffer.hpp>
+
+#include <bim/assume.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <utility>
+
+template <typename T>
+bim::ring_buffer<T>::ring_buffer()
+  : m_first(0)
+  , m_size(0)
+{}
+
+template <typename T>
+bim::ring_buffer<T>::~ring_buffer() = default;
+
+template <typename T>
+bim::ring_buffer<T>::ring_buffer(const ring_buffer<T>& that) = default;
+
+template <typename T>
+bim::ring_buffer<T>::ring_buffer(ring_buffer<T>&& that) noexcept
+  : m_data(std::move(that.m_data))
+  , m_first(that.m_first)
+  , m_size(that.m_size)
+{
+  that.m_first = 0;
+  that.m_size = 0;
+}
+
+template <typename T>
+bim::ring_buffer<T>&
+bim::ring_buffer<T>::operator=(const ring_buffer<T>& that) = default;
+
+template <typename T>
+bim::ring_buffer<T>&
+bim::ring_buffer<T>::operator=(ring_buffer<T>&& that) noexcept
+{
+  m_data = std::move(that.m_data);
+  m_first = that.m_first;
+  m_size = that.m_size;
+
+  that.m_data.clear();
+  that.m_first = 0;
+  that.m_size = 0;
+
+  return *this;
+}
+
+template <typename T>
+std::size_t bim::ring_buffer<T>::size() const
+{
+  return m_size;
+}
+
+template <typename T>
+bool bim::ring_buffer<T>::empty() const
+{
+  return m_size == 0;
+}
+
+template <typename T>
+std::size_t bim::ring_buffer<T>::capacity() const
+{
+  return m_data.size();
+}
+
+template <typename T>
+void bim::ring_buffer<T>::reserve(std::size_t n)
+{
+  if (n <= m_data.size())
+    return;
+
+  std::vector<T> data(std::bit_ceil(n));
+
+  for (std::size_t i = 0; i != m_size; ++i)
+    data[i] = std::move(m_data[index(i)]);
+
+  m_data = std::move(data);
+  m_first = 0;
+}
+
+template <typename T>
+T& bim::ring_buffer<T>::operator[](std::size_t i)
+{
+  bim_assume(i < m_size);
+  return m_data[index(i)];
+}
+
+template <typename T>
+const T& bim::ring_buffer<T>::operator[](std::size_t i) const
+{
+  bim_assume(i < m_size);
+  return m_data[index(i)];
+}
+
+template <typename T>
+void bim::ring_buffer<T>::push_back(const T& value)
+{
+  reserve(m_size + 1);
+
+  m_data[index(m_size)] = value;
+  ++m_size;
+}
+
+template <typename T>
+template <typename Iterator>
+void bim::ring_buffer<T>::append(Iterator first, Iterator last)
+{
+  reserve(m_size + std::distance(first, last));
+
+  for (; first != last; ++first)
+    {
+      m_data[index(m_size)] = *first;
+      ++m_size;
+    }
+}
+
+template <typename T>
+void bim::ring_buffer<T>::pop_front(std::size_t n)
+{
+  bim_assume(n <= m_size);
+
+  if (n == m_size)
+    {
+      clear();
+      return;
+    }
+
+  m_first = index(n);
+  m_size -= n;
+}
+
+template <typename T>
+void bim::ring_buffer<T>::clear()
+{
+  m_first = 0;
+  m_size = 0;
+}
+
+template <typename T>
+std::array<std::span<const T>, 2>
+bim::ring_buffer<T>::range(std::size_t i, std::size_t n) const
+{
+  bim_assume(i + n <= m_size);
+
+  if (n == 0)
+    return {};
+
+  const std::size_t start = index(i);
+  const std::size_t head_size = std::min(n, m_data.size() - start);
+
+  return { std::span<const T>(m_data.data() + start, head_size),
+           std::span<const T>(m_data.data(), n - head_size) };
+}
+
+template <typename T>
+std::size_t bim::ring_buffer<T>::index(std::size_t i) const
+{
+  // The capacity is a power of two.
+  return (m_first + i) & (m_data.size() - 1);
+}
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/deadline_queue.impl.hpp>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+TEST(bim_deadline_queue, order)
+{
+  bim::deadline_queue<int> q;
+
+  EXPECT_TRUE(q.empty());
+
+  q.push(3, std::chrono::nanoseconds(30));
+  q.push(1, std::chrono::nanoseconds(10));
+  q.push(4, std::chrono::nanoseconds(40));
+  q.push(2, std::chrono::nanoseconds(20));
+
+  EXPECT_EQ(4, q.size());
+
+  std::vector<int> expired;
+  const auto expire = [&](int key) -> std::optional<std::chrono::nanoseconds>
+    {
+      expired.push_back(key);
+      return std::nullopt;
+    };
+
+  q.pop_expired(std::chrono::nanoseconds(5), expire);
+  EXPECT_TRUE(expired.empty());
+  EXPECT_EQ(4, q.size());
+
+  q.pop_expired(std::chrono::nanoseconds(30), expire);
+  ASSERT_EQ(3, expired.size());
+  EXPECT_EQ(1, expired[0]);
+  EXPECT_EQ(2, expired[1]);
+  EXPECT_EQ(3, expired[2]);
+  EXPECT_EQ(1, q.size());
+
+  q.pop_expired(std::chrono::nanoseconds(100), expire);
+  ASSERT_EQ(4, expired.size());
+  EXPECT_EQ(4, expired[3]);
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(bim_deadline_queue, postpone)
+{
+  bim::deadline_queue<int> q;
+
+  // The actual deadlines, updated without touching the queue.
+  std::vector<std::chrono::nanoseconds> deadline = {
+    std::chrono::nanoseconds(10), std::chrono::nanoseconds(20)
+  };
+
+  q.push(0, deadline[0]);
+  q.push(1, deadline[1]);
+
+  deadline[0] = std::chrono::nanoseconds(50);
+
+  std::chrono::nanoseconds now(20);
+  std::vector<int> expired;
+  const auto expire = [&](int key) -> std::optional<std::chrono::nanoseconds>
+    {
+      if (deadline[key] > now)
+        return deadline[key];
+
+      expired.push_back(key);
+      return std::nullopt;
+    };
+
+  // The first key is queued again for its new deadline, the second one
+  // expires.
+  q.pop_expired(now, expire);
+  ASSERT_EQ(1, expired.size());
+  EXPECT_EQ(1, expired[0]);
+  EXPECT_EQ(1, q.size());
+
+  now = std::chrono::nanoseconds(49);
+  q.pop_expired(now, expire);
+  EXPECT_EQ(1, expired.size());
+  EXPECT_EQ(1, q.size());
+
+  now = std::chrono::nanoseconds(50);
+  q.pop_expired(now, expire);
+  ASSERT_EQ(2, expired.size());
+  EXPECT_EQ(0, expired[1]);
+  EXPECT_TRUE(q.empty());
+}
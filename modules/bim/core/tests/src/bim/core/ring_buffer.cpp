@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/ring_buffer.impl.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(bim_ring_buffer, push_pop)
+{
+  bim::ring_buffer<int> b;
+
+  EXPECT_TRUE(b.empty());
+  EXPECT_EQ(0, b.size());
+
+  b.push_back(10);
+  b.push_back(20);
+  b.push_back(30);
+
+  EXPECT_FALSE(b.empty());
+  ASSERT_EQ(3, b.size());
+  EXPECT_EQ(10, b[0]);
+  EXPECT_EQ(20, b[1]);
+  EXPECT_EQ(30, b[2]);
+
+  b.pop_front(2);
+
+  ASSERT_EQ(1, b.size());
+  EXPECT_EQ(30, b[0]);
+
+  b.pop_front(1);
+  EXPECT_TRUE(b.empty());
+}
+
+TEST(bim_ring_buffer, capacity)
+{
+  bim::ring_buffer<int> b;
+
+  b.reserve(5);
+  EXPECT_EQ(8, b.capacity());
+
+  // Filling and emptying the buffer does not change the capacity.
+  int front = 0;
+
+  for (int i = 0; i != 100; ++i)
+    {
+      b.push_back(i);
+
+      if (b.size() == 5)
+        {
+          EXPECT_EQ(front, b[0]) << "i=" << i;
+          EXPECT_EQ(i, b[4]) << "i=" << i;
+
+          b.pop_front(3);
+          front += 3;
+        }
+    }
+
+  EXPECT_EQ(8, b.capacity());
+}
+
+TEST(bim_ring_buffer, grow)
+{
+  bim::ring_buffer<int> b;
+  b.reserve(4);
+
+  b.push_back(0);
+  b.push_back(1);
+  b.push_back(2);
+  b.pop_front(2);
+
+  // The content wraps around the end of the storage, then the storage grows.
+  for (int i = 3; i != 10; ++i)
+    b.push_back(i);
+
+  EXPECT_EQ(8, b.capacity());
+  ASSERT_EQ(8, b.size());
+
+  for (int i = 0; i != 8; ++i)
+    EXPECT_EQ(i + 2, b[i]) << "i=" << i;
+}
+
+TEST(bim_ring_buffer, append)
+{
+  bim::ring_buffer<int> b;
+  b.push_back(0);
+
+  const int values[] = { 1, 2, 3, 4, 5 };
+  b.append(std::begin(values), std::end(values));
+
+  ASSERT_EQ(6, b.size());
+
+  for (int i = 0; i != 6; ++i)
+    EXPECT_EQ(i, b[i]) << "i=" << i;
+}
+
+TEST(bim_ring_buffer, range)
+{
+  bim::ring_buffer<int> b;
+  b.reserve(4);
+
+  for (int i = 0; i != 4; ++i)
+    b.push_back(i);
+
+  b.pop_front(3);
+  b.push_back(4);
+  b.push_back(5);
+
+  // Storage: [4, 5, x, 3].
+  const std::array<std::span<const int>, 2> all = b.range(0, 3);
+
+  ASSERT_EQ(1, all[0].size());
+  EXPECT_EQ(3, all[0][0]);
+  ASSERT_EQ(2, all[1].size());
+  EXPECT_EQ(4, all[1][0]);
+  EXPECT_EQ(5, all[1][1]);
+
+  const std::array<std::span<const int>, 2> tail = b.range(1, 2);
+
+  ASSERT_EQ(2, tail[0].size());
+  EXPECT_EQ(4, tail[0][0]);
+  EXPECT_EQ(5, tail[0][1]);
+  EXPECT_TRUE(tail[1].empty());
+
+  EXPECT_TRUE(b.range(1, 0)[0].empty());
+  EXPECT_TRUE(b.range(1, 0)[1].empty());
+}
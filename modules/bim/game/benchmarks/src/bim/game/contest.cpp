@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/contest.hpp>
+
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/contest_result.hpp>
+#include <bim/game/feature_flags.hpp>
+#include <bim/game/system_timings.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <utility>
+
+static constexpr std::array<std::pair<std::uint8_t, std::uint8_t>, 3>
+    g_arena_sizes = { { { 13, 15 }, { 17, 19 }, { 21, 23 } } };
+
+/**
+ * Run full contests with bots. The arguments are the combination of the
+ * feature flags, as a bitset over g_all_game_feature_flags, the player count,
+ * and the index of the arena size in g_arena_sizes.
+ *
+ * Only the calls to contest::tick() are measured. The counter of each system
+ * is its average execution time per tick, in nanoseconds.
+ */
+static void contest_tick(benchmark::State& state)
+{
+  bim::game::feature_flags features{};
+
+  for (std::size_t i = 0; i != bim::game::g_all_game_feature_flags.size();
+       ++i)
+    if (state.range(0) & (1 << i))
+      features = features | bim::game::g_all_game_feature_flags[i];
+
+  const std::uint8_t player_count = state.range(1);
+  const std::pair<std::uint8_t, std::uint8_t> arena_size =
+      g_arena_sizes[state.range(2)];
+
+  bim::game::contest_fingerprint fingerprint = {
+    .seed = 0,
+    .features = features,
+    .player_count = player_count,
+    .crate_probability = 50,
+    .arena_width = arena_size.first,
+    .arena_height = arena_size.second
+  };
+
+  bim::game::system_timings timings;
+  std::uint64_t tick_count = 0;
+
+  for (auto _ : state)
+    {
+      bim::game::contest contest(fingerprint);
+      contest.measure_systems(&timings);
+
+      bim::game::tests::bot_players bots(contest, player_count,
+                                         fingerprint.seed);
+
+      std::chrono::nanoseconds tick_duration(0);
+      bool still_running = true;
+
+      while (still_running)
+        {
+          bots.think(contest);
+
+          const std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          still_running = contest.tick().still_running();
+          tick_duration += std::chrono::steady_clock::now() - start;
+
+          ++tick_count;
+        }
+
+      state.SetIterationTime(
+          std::chrono::duration<double>(tick_duration).count());
+
+      // Play a different game in the next iteration.
+      ++fingerprint.seed;
+    }
+
+  state.counters["Ticks"] =
+      benchmark::Counter(tick_count, benchmark::Counter::kIsRate);
+
+  for (std::size_t i = 0; i != bim::game::system_timings::system_count; ++i)
+    state.counters[std::string(
+        bim::game::system_name((bim::game::system_id)i))] =
+        (double)timings.duration[i].count() / tick_count;
+}
+
+BENCHMARK(contest_tick)
+    ->ArgNames({ "features", "players", "arena" })
+    ->ArgsProduct(
+        { benchmark::CreateDenseRange(
+              0, (1 << bim::game::g_all_game_feature_flags.size()) - 1, 1),
+          benchmark::CreateDenseRange(2, 4, 1),
+          benchmark::CreateDenseRange(0, g_arena_sizes.size() - 1, 1) })
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Run full contests with bots and all the features, and measure only the
+ * movements of the players, i.e. the apply_player_action system. The
+ * arguments are the player count and the index of the arena size in
+ * g_arena_sizes.
+ *
+ * This is the reference for the changes in the storage of the components of
+ * the players.
+ */
+static void contest_apply_player_action(benchmark::State& state)
+{
+  bim::game::feature_flags features{};
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    features = features | f;
+
+  const std::uint8_t player_count = state.range(0);
+  const std::pair<std::uint8_t, std::uint8_t> arena_size =
+      g_arena_sizes[state.range(1)];
+
+  bim::game::contest_fingerprint fingerprint = {
+    .seed = 0,
+    .features = features,
+    .player_count = player_count,
+    .crate_probability = 50,
+    .arena_width = arena_size.first,
+    .arena_height = arena_size.second
+  };
+
+  constexpr std::size_t system =
+      (std::size_t)bim::game::system_id::apply_player_action;
+
+  bim::game::system_timings timings;
+  std::uint64_t tick_count = 0;
+
+  for (auto _ : state)
+    {
+      bim::game::contest contest(fingerprint);
+      contest.measure_systems(&timings);
+
+      bim::game::tests::bot_players bots(contest, player_count,
+                                         fingerprint.seed);
+
+      const std::chrono::nanoseconds start = timings.duration[system];
+      bool still_running = true;
+
+      while (still_running)
+        {
+          still_running = bots.tick(contest).still_running();
+          ++tick_count;
+        }
+
+      state.SetIterationTime(std::chrono::duration<double>(
+                                 timings.duration[system] - start)
+                                 .count());
+
+      // Play a different game in the next iteration.
+      ++fingerprint.seed;
+    }
+
+  state.counters["Ticks"] =
+      benchmark::Counter(tick_count, benchmark::Counter::kIsRate);
+  state.counters["ns/tick"] =
+      (double)timings.duration[system].count() / tick_count;
+}
+
+BENCHMARK(contest_apply_player_action)
+    ->ArgNames({ "players", "arena" })
+    ->ArgsProduct({ benchmark::CreateDenseRange(2, 4, 1),
+                    benchmark::CreateDenseRange(0, g_arena_sizes.size() - 1,
+                                                1) })
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/entity_world_map.hpp>
+
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/feature_flags.hpp>
+
+#include <bim/table_2d.impl.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <boost/container/small_vector.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  /// The layout of entity_world_map before it was flattened.
+  using small_vector_world_map =
+      bim::table_2d<boost::container::small_vector<entt::entity, 8>>;
+}
+
+/// The entity map of a game with bots, in the middle of the game.
+static bim::game::entity_world_map contest_entity_map()
+{
+  bim::game::feature_flags features{};
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    features = features | f;
+
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 1234,
+    .features = features,
+    .player_count = 4,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  bim::game::contest contest(fingerprint);
+  bim::game::tests::bot_players(contest, fingerprint.player_count,
+                                fingerprint.seed)
+      .run(contest, 200);
+
+  return contest.entity_map();
+}
+
+static small_vector_world_map
+to_small_vector_world_map(const bim::game::entity_world_map& entity_map)
+{
+  small_vector_world_map result(bim::game::g_default_arena_width,
+                                bim::game::g_default_arena_height);
+
+  for (std::uint8_t y = 0; y != result.height(); ++y)
+    for (std::uint8_t x = 0; x != result.width(); ++x)
+      {
+        const std::span<const entt::entity> entities =
+            entity_map.entities_at(x, y);
+        result(x, y).assign(entities.begin(), entities.end());
+      }
+
+  return result;
+}
+
+// The copies are done like the save and the restore in
+// bim::net::contest_runner: into an existing map of the same size.
+
+static void entity_world_map_copy_small_vector(benchmark::State& state)
+{
+  const small_vector_world_map source =
+      to_small_vector_world_map(contest_entity_map());
+  small_vector_world_map target(source.width(), source.height());
+
+  for (auto _ : state)
+    {
+      target = source;
+      benchmark::DoNotOptimize(target);
+    }
+}
+
+BENCHMARK(entity_world_map_copy_small_vector);
+
+static void entity_world_map_copy_flat(benchmark::State& state)
+{
+  const bim::game::entity_world_map source = contest_entity_map();
+  bim::game::entity_world_map target(bim::game::g_default_arena_width,
+                                     bim::game::g_default_arena_height);
+
+  for (auto _ : state)
+    {
+      target = source;
+      benchmark::DoNotOptimize(target);
+    }
+}
+
+BENCHMARK(entity_world_map_copy_flat);
+
+// The lookups visit all the entities of all the cells, like a scan of the
+// cells reached by the flames.
+
+static void entity_world_map_lookup_small_vector(benchmark::State& state)
+{
+  const small_vector_world_map entity_map =
+      to_small_vector_world_map(contest_entity_map());
+
+  for (auto _ : state)
+    for (std::uint8_t y = 0; y != entity_map.height(); ++y)
+      for (std::uint8_t x = 0; x != entity_map.width(); ++x)
+        for (entt::entity e : entity_map(x, y))
+          benchmark::DoNotOptimize(e);
+}
+
+BENCHMARK(entity_world_map_lookup_small_vector);
+
+static void entity_world_map_lookup_flat(benchmark::State& state)
+{
+  const bim::game::entity_world_map entity_map = contest_entity_map();
+
+  for (auto _ : state)
+    for (std::uint8_t y = 0; y != bim::game::g_default_arena_height; ++y)
+      for (std::uint8_t x = 0; x != bim::game::g_default_arena_width; ++x)
+        for (entt::entity e : entity_map.entities_at(x, y))
+          benchmark::DoNotOptimize(e);
+}
+
+BENCHMARK(entity_world_map_lookup_flat);
@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/game_state_snapshot.hpp>
+
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/archive_storage.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/feature_flags.hpp>
+#include <bim/game/game_state_serialization.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+  /**
+   * A contest with bots, in which we can move forward, like the client does
+   * between two updates from the server.
+   */
+  class bot_contest
+  {
+  public:
+    bot_contest()
+      : m_contest(fingerprint())
+      , m_bots(m_contest, g_player_count, 1234)
+    {
+      // Skip the beginning of the game, where there are no bombs, no flames,
+      // and no power-ups.
+      run(100);
+    }
+
+    entt::registry& registry()
+    {
+      return m_contest.registry();
+    }
+
+    void run(int tick_count)
+    {
+      m_bots.run(m_contest, tick_count);
+    }
+
+  private:
+    static constexpr int g_player_count = 4;
+
+  private:
+    static bim::game::contest_fingerprint fingerprint()
+    {
+      bim::game::feature_flags features{};
+
+      for (const bim::game::feature_flags f :
+           bim::game::g_all_game_feature_flags)
+        features = features | f;
+
+      return { .seed = 1234,
+               .features = features,
+               .player_count = g_player_count,
+               .crate_probability = 50,
+               .arena_width = bim::game::g_default_arena_width,
+               .arena_height = bim::game::g_default_arena_height };
+    }
+
+  private:
+    bim::game::contest m_contest;
+    bim::game::tests::bot_players m_bots;
+  };
+}
+
+// The benchmarks below alternate between a confirmed state and a predicted
+// state, the latter being state.range(0) ticks after the former. On each
+// state the rollback state is saved, like in bim::net::contest_runner.
+
+static void game_state_rollback_full_archive(benchmark::State& state)
+{
+  bot_contest contest;
+  entt::registry& registry = contest.registry();
+
+  bim::game::archive_storage confirmed;
+  bim::game::serialize_state(confirmed, registry);
+
+  contest.run(state.range(0));
+
+  bim::game::archive_storage predicted;
+  bim::game::serialize_state(predicted, registry);
+
+  bim::game::archive_storage rollback;
+
+  for (auto _ : state)
+    {
+      bim::game::deserialize_state(registry, confirmed);
+      bim::game::serialize_state(rollback, registry);
+      bim::game::deserialize_state(registry, predicted);
+      bim::game::serialize_state(rollback, registry);
+    }
+}
+
+BENCHMARK(game_state_rollback_full_archive)->Arg(1)->Arg(5)->Arg(20);
+
+static void game_state_rollback_snapshot(benchmark::State& state)
+{
+  bot_contest contest;
+  entt::registry& registry = contest.registry();
+
+  bim::game::game_state_snapshot confirmed;
+  confirmed.save(registry);
+
+  contest.run(state.range(0));
+
+  bim::game::game_state_snapshot predicted;
+  predicted.save(registry);
+
+  bim::game::game_state_snapshot rollback;
+
+  for (auto _ : state)
+    {
+      confirmed.restore(registry);
+      rollback.save(registry);
+      predicted.restore(registry);
+      rollback.save(registry);
+    }
+}
+
+BENCHMARK(game_state_rollback_snapshot)->Arg(1)->Arg(5)->Arg(20);
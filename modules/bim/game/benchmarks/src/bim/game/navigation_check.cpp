@@ -14,6 +14,15 @@
 
 #include <benchmark/benchmark.h>
 
+// The benchmarks are run with the best-first search (argument 0) and with the
+// bitboards (argument 1).
+static bim::game::navigation_check::algorithm
+algorithm(const benchmark::State& state)
+{
+  return state.range(0) ? bim::game::navigation_check::algorithm::bitboard
+                        : bim::game::navigation_check::algorithm::best_first;
+}
+
 static void navigation_check_reachable(benchmark::State& state)
 {
   const std::size_t arena_width = bim::game::g_default_arena_width;
@@ -21,7 +30,7 @@ static void navigation_check_reachable(benchmark::State& state)
 
   bim::game::arena arena(arena_width, arena_height);
   bim::game::generate_basic_level_structure(arena);
-  bim::game::navigation_check nav;
+  bim::game::navigation_check nav(algorithm(state));
 
   std::vector<bim::game::position_on_grid> start;
   start.reserve(arena.width() * arena.height());
@@ -42,14 +51,14 @@ static void navigation_check_reachable(benchmark::State& state)
   state.counters["Calls"] = start.size();
 }
 
-BENCHMARK(navigation_check_reachable);
+BENCHMARK(navigation_check_reachable)->ArgName("bitboard")->Arg(0)->Arg(1);
 
 static void navigation_check_paths(benchmark::State& state)
 {
   bim::game::arena arena(bim::game::g_default_arena_width,
                          bim::game::g_default_arena_height);
   bim::game::generate_basic_level_structure(arena);
-  bim::game::navigation_check nav;
+  bim::game::navigation_check nav(algorithm(state));
   bim::table_2d<std::uint8_t> distance(arena.width(), arena.height());
   bim::table_2d<bim::game::position_on_grid> previous(arena.width(),
                                                       arena.height());
@@ -89,14 +98,14 @@ static void navigation_check_paths(benchmark::State& state)
   state.counters["Calls"] = start.size();
 }
 
-BENCHMARK(navigation_check_paths);
+BENCHMARK(navigation_check_paths)->ArgName("bitboard")->Arg(0)->Arg(1);
 
 static void navigation_check_exists(benchmark::State& state)
 {
   bim::game::arena arena(bim::game::g_default_arena_width,
                          bim::game::g_default_arena_height);
   bim::game::generate_basic_level_structure(arena);
-  bim::game::navigation_check nav;
+  bim::game::navigation_check nav(algorithm(state));
   entt::registry registry;
   bim::game::entity_world_map entity_map(arena.width(), arena.height());
 
@@ -129,4 +138,4 @@ static void navigation_check_exists(benchmark::State& state)
   state.counters["Calls"] = start.size();
 }
 
-BENCHMARK(navigation_check_exists);
+BENCHMARK(navigation_check_exists)->ArgName("bitboard")->Arg(0)->Arg(1);
@@ -31,6 +31,12 @@ namespace bim::game
     arena& operator=(const arena& that) noexcept;
     arena& operator=(arena&& that) noexcept;
 
+    /**
+     * Remove all walls and fences and change the size of the arena, reusing
+     * the memory of the current arena.
+     */
+    void reset(std::uint8_t width, std::uint8_t height);
+
     std::uint8_t width() const;
     std::uint8_t height() const;
 
@@ -45,9 +51,18 @@ namespace bim::game
     void add_fence(std::uint8_t x, std::uint8_t y, cell_edge e);
     void remove_fence(std::uint8_t x, std::uint8_t y, cell_edge e);
 
+    /**
+     * An identifier of the current walls and fences of the arena. It changes
+     * each time a wall or a fence is modified, and it is never the same for
+     * two different layouts, even across different arenas. Zero is never
+     * used.
+     */
+    std::uint64_t revision() const;
+
   private:
     std::uint8_t m_width;
     std::uint8_t m_height;
+    std::uint64_t m_revision;
 
     /// Static walls, they are never removed.
     table_2d<bool> m_is_static_wall;
@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/game/component/position_on_grid.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bim::game
+{
+  class arena;
+
+  /**
+   * The order in which the blocks fall in the arena when it is reduced: a
+   * spiral from the borders toward the center, skipping the static walls.
+   */
+  class arena_fall_order
+  {
+  public:
+    explicit arena_fall_order(const arena& arena);
+    ~arena_fall_order();
+
+    std::span<const position_on_grid> positions() const;
+
+  private:
+    std::vector<position_on_grid> m_positions;
+  };
+
+  /**
+   * The fall order of an arena built with generate_basic_level_structure().
+   * It is computed on the first call for a given size, then shared by all the
+   * callers. This function is thread-safe.
+   */
+  const arena_fall_order& basic_arena_fall_order(std::uint8_t width,
+                                                 std::uint8_t height);
+}
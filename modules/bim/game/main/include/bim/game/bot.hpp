@@ -7,6 +7,7 @@
 #include <bim/game/navigation_check.hpp>
 #include <bim/game/per_player_array.hpp>
 #include <bim/game/random_generator.hpp>
+#include <bim/game/world_analysis.hpp>
 
 #include <entt/fwd.hpp>
 
@@ -37,10 +38,26 @@ namespace bim::game
 
     std::uint8_t player_index() const;
 
+    /**
+     * Limit the number of cells analyzed in a call to think() when looking
+     * for a new goal. If the search is not complete within this budget then
+     * it continues in the next call, and meanwhile the bot goes toward the
+     * best goal found so far. Zero means no limit, which is the default.
+     */
+    void think_budget(std::uint16_t cell_count);
+
     player_action think(const contest& contest);
 
+    /**
+     * Same as think(contest) but with an analysis of the contest that has
+     * already been updated for the current tick, and which can be shared by
+     * all the bots of the contest.
+     */
+    player_action think(const contest& contest, const world_analysis& world);
+
   private:
     enum class state : std::uint8_t;
+    enum class goal_search : std::uint8_t;
 
     struct goal
     {
@@ -65,31 +82,46 @@ namespace bim::game
         fractional_position_on_grid& bot_fractional_position) const;
 
     int build_visibility_map(const contest& contest);
-    int build_crate_map(const contest& contest);
-    void build_solid_map(const contest& contest);
-    void build_danger_map(const contest& contest, const player& bot_player,
+    int build_crate_map(const world_analysis& world, bool full_visibility);
+    void build_solid_map(const world_analysis& world, bool full_visibility);
+    void build_danger_map(const contest& contest, const world_analysis& world,
+                          bool full_visibility, const player& bot_player,
                           const player_action_queue& queued_actions);
-    void build_power_up_map(const contest& contest);
+    void build_power_up_map(const world_analysis& world,
+                            bool full_visibility);
 
     /// Simulate the explosion of the bomb.
     void store_bomb_danger(bim::table_2d<bool>& map, const contest& contest,
                            const position_on_grid& p, int d);
 
+    /**
+     * Simulate the explosion of a bomb from the world analysis, reusing its
+     * blast if the bot sees everything.
+     */
+    void store_bomb_danger(bim::table_2d<bool>& map, const contest& contest,
+                           const world_analysis& world,
+                           const world_analysis::bomb_info& bomb,
+                           bool full_visibility);
+
     bool goal_is_feasible(const contest& contest, const player& bot_player,
                           const position_on_grid& bot_position);
-    bool find_goal(const contest& contest,
-                   const per_player_array<bool>& opponent_is_valid,
-                   const per_player_array<position_on_grid>& player_positions,
-                   const player& bot_player, int crate_count,
-                   int unknown_count);
+    goal_search
+    find_goal(const contest& contest,
+              const per_player_array<bool>& opponent_is_valid,
+              const per_player_array<position_on_grid>& player_positions,
+              const player& bot_player, int crate_count, int unknown_count);
     bool find_safety_goal();
     bool update_safety_goal(const contest& contest,
                             const position_on_grid& bot_position);
-    bool find_exploration_goal(
+    goal_search find_exploration_goal(
         const contest& contest,
         const per_player_array<bool>& opponent_is_valid,
         const per_player_array<position_on_grid>& player_positions,
         const player& bot_player);
+
+    /// Take the best goal of an interrupted exploration search, if any.
+    bool select_pending_goal();
+
     bool find_attack_goal(
         const per_player_array<bool>& opponent_is_valid,
         const per_player_array<position_on_grid>& player_positions);
@@ -193,8 +225,23 @@ namespace bim::game
     navigation_check m_navigation;
 
     std::vector<goal> m_candidate_goals;
+
+    /**
+     * The index of the next cell to analyze in find_exploration_goal(), non
+     * zero when the search has been interrupted by the budget.
+     */
+    std::size_t m_goal_search_cell;
+
+    /// The best reward of m_candidate_goals during the search.
+    int m_goal_search_best_reward;
+
+    std::uint16_t m_think_budget;
+
     random_generator m_random;
 
+    /// The analysis used when the caller does not provide one.
+    world_analysis m_world_analysis;
+
     state m_state;
     std::uint8_t m_player_index;
 
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/assume.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace bim::game
+{
+  /**
+   * One bit per cell of an arena, the cell (x, y) being at index
+   * y * width + x. The shift operators move the bits toward the higher (<<)
+   * or lower (>>) indices, such that shifting by one moves the cells
+   * horizontally and shifting by the width of the arena moves them
+   * vertically.
+   */
+  class cell_bitboard
+  {
+  public:
+    using word = std::uint64_t;
+
+    static constexpr std::size_t bits_per_word = sizeof(word) * 8;
+    static constexpr std::size_t word_count = 4;
+    static constexpr std::size_t capacity = word_count * bits_per_word;
+
+  public:
+    constexpr cell_bitboard()
+      : m_words{}
+    {}
+
+    friend bool operator==(const cell_bitboard& lhs, const cell_bitboard& rhs)
+    {
+      return lhs.m_words == rhs.m_words;
+    }
+
+    friend cell_bitboard operator&(cell_bitboard lhs, const cell_bitboard& rhs)
+    {
+      return lhs &= rhs;
+    }
+
+    friend cell_bitboard operator|(cell_bitboard lhs, const cell_bitboard& rhs)
+    {
+      return lhs |= rhs;
+    }
+
+    /// Returns lhs without the bits of rhs.
+    friend cell_bitboard operator-(cell_bitboard lhs, const cell_bitboard& rhs)
+    {
+      for (std::size_t i = 0; i != word_count; ++i)
+        lhs.m_words[i] &= ~rhs.m_words[i];
+
+      return lhs;
+    }
+
+    cell_bitboard& operator&=(const cell_bitboard& that)
+    {
+      for (std::size_t i = 0; i != word_count; ++i)
+        m_words[i] &= that.m_words[i];
+
+      return *this;
+    }
+
+    cell_bitboard& operator|=(const cell_bitboard& that)
+    {
+      for (std::size_t i = 0; i != word_count; ++i)
+        m_words[i] |= that.m_words[i];
+
+      return *this;
+    }
+
+    cell_bitboard operator<<(std::size_t n) const
+    {
+      bim_assume(n > 0);
+      bim_assume(n < bits_per_word);
+
+      cell_bitboard result;
+      result.m_words[0] = m_words[0] << n;
+
+      for (std::size_t i = 1; i != word_count; ++i)
+        result.m_words[i] = (m_words[i] << n)
+                            | (m_words[i - 1] >> (bits_per_word - n));
+
+      return result;
+    }
+
+    cell_bitboard operator>>(std::size_t n) const
+    {
+      bim_assume(n > 0);
+      bim_assume(n < bits_per_word);
+
+      cell_bitboard result;
+
+      for (std::size_t i = 0; i != word_count - 1; ++i)
+        result.m_words[i] = (m_words[i] >> n)
+                            | (m_words[i + 1] << (bits_per_word - n));
+
+      result.m_words[word_count - 1] = m_words[word_count - 1] >> n;
+
+      return result;
+    }
+
+    bool any() const
+    {
+      word result = 0;
+
+      for (std::size_t i = 0; i != word_count; ++i)
+        result |= m_words[i];
+
+      return result != 0;
+    }
+
+    bool test(std::size_t i) const
+    {
+      bim_assume(i < capacity);
+      return m_words[i / bits_per_word] & (word(1) << (i % bits_per_word));
+    }
+
+    void set(std::size_t i)
+    {
+      bim_assume(i < capacity);
+      m_words[i / bits_per_word] |= word(1) << (i % bits_per_word);
+    }
+
+    void reset(std::size_t i)
+    {
+      bim_assume(i < capacity);
+      m_words[i / bits_per_word] &= ~(word(1) << (i % bits_per_word));
+    }
+
+    /// Calls f(i) for each bit i set in this bitboard, in increasing order.
+    template <typename F>
+    void for_each(F&& f) const
+    {
+      for (std::size_t i = 0; i != word_count; ++i)
+        for (word w = m_words[i]; w != 0; w &= w - 1)
+          f(i * bits_per_word + std::countr_zero(w));
+    }
+
+  private:
+    std::array<word, word_count> m_words;
+  };
+}
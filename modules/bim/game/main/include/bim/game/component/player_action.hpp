@@ -9,6 +9,12 @@ namespace bim::game
 {
   struct player_action
   {
+    friend bool operator==(const player_action& lhs, const player_action& rhs)
+    {
+      return (lhs.movement == rhs.movement)
+             && (lhs.drop_bomb == rhs.drop_bomb);
+    }
+
     player_movement movement;
     bool drop_bomb;
   };
@@ -8,18 +8,23 @@
 #include <entt/entity/fwd.hpp>
 
 #include <chrono>
+#include <cstdint>
 #include <memory>
 
 namespace bim::game
 {
   class arena;
+  class arena_fall_order;
   class arena_reduction;
   class contest_result;
   class context;
   class entity_world_map;
   class fog_of_war_updater;
+  class incremental_game_state_checksum;
+  class player_table;
   struct contest_fingerprint;
   struct fog_of_war;
+  struct system_timings;
 
   class contest
   {
@@ -33,6 +38,12 @@ namespace bim::game
     explicit contest(const contest_fingerprint& fingerprint);
     ~contest();
 
+    /**
+     * Start a new game, in the same state than contest(fingerprint), but
+     * reusing the memory of the current game.
+     */
+    void reset(const contest_fingerprint& fingerprint);
+
     contest_result tick();
 
     const bim::game::context& context() const;
@@ -42,19 +53,43 @@ namespace bim::game
 
     const bim::game::arena& arena() const;
 
+    /// The order in which the blocks fall when the arena is reduced.
+    const arena_fall_order& fall_order() const;
+
     const bim::game::entity_world_map& entity_map() const;
     void entity_map(const bim::game::entity_world_map& m);
 
     const bim::table_2d<bim::game::fog_of_war*>&
     fog_map(std::size_t player_index) const;
 
+    /// The same as game_state_checksum(registry()), but faster.
+    std::uint32_t state_checksum() const;
+
+    /**
+     * Add the execution time of each system in the next calls to tick() to
+     * the given timings. Pass nullptr to stop the measures.
+     */
+    void measure_systems(bim::game::system_timings* timings);
+
+  private:
+    void generate(const contest_fingerprint& fingerprint);
+
   private:
     const std::unique_ptr<entt::registry> m_registry;
-    const std::unique_ptr<bim::game::context> m_context;
+    const std::unique_ptr<incremental_game_state_checksum> m_state_checksum;
+
+    /// Shared with all the other contests.
+    const bim::game::context& m_context;
+
     const std::unique_ptr<bim::game::arena> m_arena;
     const std::unique_ptr<entity_world_map> m_entity_world_map;
 
+    /// The players of m_registry, for the movement systems.
+    const std::unique_ptr<player_table> m_players;
+
     std::unique_ptr<arena_reduction> m_arena_reduction;
     std::unique_ptr<fog_of_war_updater> m_fog_of_war;
+
+    bim::game::system_timings* m_system_timings;
   };
 }
@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace bim::game
+{
+  class contest;
+  struct contest_fingerprint;
+
+  /**
+   * A collection of contests that are not used anymore, kept to start the
+   * next games without allocating a new contest.
+   */
+  class contest_pool
+  {
+  public:
+    /// \param max_size How many unused contests we keep at most.
+    explicit contest_pool(std::size_t max_size);
+    ~contest_pool();
+
+    /**
+     * Get a contest in the same state than contest(fingerprint), either by
+     * resetting a released contest or by creating a new one.
+     */
+    std::unique_ptr<contest> acquire(const contest_fingerprint& fingerprint);
+
+    /// Put back a contest for a next call to acquire().
+    void release(std::unique_ptr<contest> c);
+
+    std::size_t size() const;
+
+  private:
+    const std::size_t m_max_size;
+    std::vector<std::unique_ptr<contest>> m_contests;
+  };
+}
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+namespace bim::game
+{
+  class context;
+
+  /**
+   * The context filled with fill_context(), built on the first call and
+   * shared by all the contests of the process. It is never modified
+   * afterwards, thus it can be read from any thread.
+   */
+  const context& shared_context();
+}
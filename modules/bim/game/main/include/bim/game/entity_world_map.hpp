@@ -1,16 +1,20 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #pragma once
 
-#include <bim/table_2d.hpp>
-
 #include <entt/entity/fwd.hpp>
 
-#include <boost/container/small_vector.hpp>
-
+#include <cstdint>
 #include <span>
+#include <vector>
 
 namespace bim::game
 {
+  /**
+   * The entities in each cell of the arena. The entities are stored in a
+   * single flat array, with the same number of slots for every cell, such
+   * that copying a map is just a copy of two arrays of plain data. The
+   * number of slots per cell grows when a cell is full.
+   */
   class entity_world_map
   {
   public:
@@ -23,6 +27,12 @@ namespace bim::game
     entity_world_map& operator=(const entity_world_map& that);
     entity_world_map& operator=(entity_world_map&& that) noexcept;
 
+    /**
+     * Remove all entities and change the size of the map, reusing the memory
+     * of the current map.
+     */
+    void reset(std::uint8_t width, std::uint8_t height);
+
     std::span<const entt::entity> entities_at(std::uint8_t x,
                                               std::uint8_t y) const;
     void put_entity(entt::entity e, std::uint8_t x, std::uint8_t y);
@@ -30,9 +40,22 @@ namespace bim::game
     void erase_entities(std::uint8_t x, std::uint8_t y);
 
   private:
-    using entity_vector = boost::container::small_vector<entt::entity, 8>;
+    std::size_t cell_index(std::uint8_t x, std::uint8_t y) const;
+    void grow_cells();
 
   private:
-    table_2d<entity_vector> m_entities;
+    std::uint8_t m_width;
+    std::uint8_t m_height;
+
+    /// The number of slots for each cell in m_entities.
+    std::uint8_t m_cell_capacity;
+
+    /// The number of entities in each cell, row by row.
+    std::vector<std::uint8_t> m_entity_count;
+
+    /**
+     * The entities of the cells, row by row, m_cell_capacity slots per cell.
+     */
+    std::vector<entt::entity> m_entities;
   };
 }
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+/**
+ * This file uses the X-macro idiom to generate code that must be executed for
+ * every system of contest::tick(), in the order in which they are executed.
+ */
+
+bim_game_x_system(refresh_bomb_inventory)                 //
+    bim_game_x_system(update_clocks)                      //
+    bim_game_x_system(update_timers)                      //
+    bim_game_x_system(animator)                           //
+    bim_game_x_system(apply_player_action)                //
+    bim_game_x_system(arena_reduction)                    //
+    bim_game_x_system(update_falling_blocks)              //
+    bim_game_x_system(trigger_crushed_timers)             //
+    bim_game_x_system(update_bombs)                       //
+    bim_game_x_system(update_flames)                      //
+    bim_game_x_system(update_invincibility_state)         //
+    bim_game_x_system(update_shields)                     //
+    bim_game_x_system(update_crates)                      //
+    bim_game_x_system(update_invisibility_state)          //
+    bim_game_x_system(bomb_power_up_spawner)              //
+    bim_game_x_system(flame_power_up_spawner)             //
+    bim_game_x_system(invisibility_power_up_spawner)      //
+    bim_game_x_system(shield_power_up_spawner)            //
+    bim_game_x_system(update_power_ups)                   //
+    bim_game_x_system(update_bomb_power_ups)              //
+    bim_game_x_system(update_flame_power_ups)             //
+    bim_game_x_system(update_invisibility_power_ups)      //
+    bim_game_x_system(update_shield_power_ups)            //
+    bim_game_x_system(update_players)                     //
+    bim_game_x_system(fog_of_war)                         //
+    bim_game_x_system(remove_dead_objects)                //
+
+#undef bim_game_x_system
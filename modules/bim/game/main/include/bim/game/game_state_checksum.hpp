@@ -3,9 +3,74 @@
 
 #include <entt/entity/fwd.hpp>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
 namespace bim::game
 {
   std::uint32_t game_state_checksum(const entt::registry& registry);
+
+  /**
+   * Maintains the value of game_state_checksum() for a given registry while
+   * it is updated.
+   *
+   * The checksum being a sum of bytes, the contribution of the entities and
+   * of the component memberships is updated by the construction and
+   * destruction hooks of the registry. The values of the components are
+   * modified in place by the systems, without notification, thus they are
+   * summed directly from the component storages when the checksum is
+   * requested. There is no need to sort nor to look up the entities.
+   *
+   * entt::snapshot_loader creates every archived entity, including the
+   * released ones, then shrinks the free list without triggering the
+   * destruction hooks. The entity sum is thus recomputed from the registry
+   * when its count differs from the count of entities in use.
+   */
+  class incremental_game_state_checksum
+  {
+  public:
+    explicit incremental_game_state_checksum(entt::registry& registry);
+    ~incremental_game_state_checksum();
+
+    incremental_game_state_checksum(const incremental_game_state_checksum&) =
+        delete;
+    incremental_game_state_checksum&
+    operator=(const incremental_game_state_checksum&) = delete;
+
+    /// Returns the same value than game_state_checksum(registry).
+    std::uint32_t value() const;
+
+  private:
+    static constexpr std::size_t component_type_count =
+#define bim_game_x_component(n) +1
+#include <bim/game/for_each_component.hpp>
+        ;
+
+  private:
+    void resync_entities() const;
+
+    void on_entity_construct(entt::registry& registry, entt::entity e);
+    void on_entity_destroy(entt::registry& registry, entt::entity e);
+
+    template <typename T>
+    void on_component_construct(entt::registry& registry, entt::entity e);
+    template <typename T>
+    void on_component_destroy(entt::registry& registry, entt::entity e);
+
+  private:
+    entt::registry& m_registry;
+
+    mutable std::uint32_t m_entity_checksum;
+    mutable std::size_t m_entity_count;
+
+    /**
+     * Sum of the checksums of the entities having a component, for each
+     * component type.
+     */
+    std::array<std::uint32_t, component_type_count> m_component_checksum;
+
+    /// Count of entities having a component, for each component type.
+    std::array<std::uint16_t, component_type_count> m_component_count;
+  };
 }
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <entt/entity/fwd.hpp>
+
+#include <memory>
+#include <vector>
+
+namespace bim::game
+{
+  /**
+   * A copy of the entities and components of a registry, kept to go back to
+   * a previous state of a game. Contrary to serialize_state() and
+   * deserialize_state(), the storages are compared with the ones of the
+   * registry and only those that differ are copied, in both directions.
+   */
+  class game_state_snapshot
+  {
+  public:
+    game_state_snapshot();
+    game_state_snapshot(const game_state_snapshot&) = delete;
+    ~game_state_snapshot();
+
+    game_state_snapshot& operator=(const game_state_snapshot&) = delete;
+
+    void save(const entt::registry& registry);
+
+    /**
+     * Put the registry back in the state it had at the time of the last call
+     * to save(). The storages are restored in place: only the components
+     * after the first difference with the saved entities are recreated, and
+     * the sequence of entities is rebuilt only if entities have been created
+     * or destroyed since then.
+     */
+    void restore(entt::registry& registry) const;
+
+  private:
+    struct storages;
+
+  private:
+    /**
+     * The size of the entity storage, followed by its free list, then the
+     * entities in their packed order. This is the format expected by
+     * entt::snapshot_loader.
+     */
+    std::vector<entt::entity> m_entities;
+
+    std::unique_ptr<storages> m_storages;
+  };
+}
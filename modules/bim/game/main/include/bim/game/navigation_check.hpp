@@ -1,10 +1,13 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #pragma once
 
+#include <bim/game/cell_bitboard.hpp>
+
 #include <bim/table_2d.hpp>
 
 #include <entt/entity/fwd.hpp>
 
+#include <array>
 #include <cstdint>
 #include <vector>
 
@@ -26,10 +29,34 @@ namespace bim::game
     // Everything from this distance and above in unreachable.
     static constexpr std::uint8_t unreachable = 254;
 
+    /// The implementations of the searches.
+    enum class algorithm : std::uint8_t
+    {
+      /**
+       * Use the bitboards if the arena is small enough, otherwise use the
+       * best-first search.
+       */
+      automatic,
+
+      /// Search over a queue of cells sorted by distance. Works everywhere.
+      best_first,
+
+      /**
+       * Wavefront expansion over bitboards. Only for arenas fitting in a
+       * cell_bitboard. The previous cell of a given cell in paths() may
+       * differ from the one of best_first when there are several shortest
+       * paths.
+       */
+      bitboard
+    };
+
   public:
     navigation_check();
+    explicit navigation_check(algorithm a);
     ~navigation_check();
 
+    static bool fits_in_bitboard(const arena& arena);
+
     bool reachable(const arena& arena, std::uint8_t from_x,
                    std::uint8_t from_y, std::uint8_t to_x, std::uint8_t to_y);
     void paths(bim::table_2d<std::uint8_t>& distance,
@@ -45,13 +72,50 @@ namespace bim::game
   private:
     enum class scan_loop_policy : std::uint8_t;
 
+    bool use_bitboard(const arena& arena) const;
+    void build_moves(const arena& arena);
+    cell_bitboard move(const cell_bitboard& cells, int direction) const;
+
+    bool reachable_bitboard(const arena& arena, std::uint8_t from_x,
+                            std::uint8_t from_y, std::uint8_t to_x,
+                            std::uint8_t to_y);
+    void paths_bitboard(bim::table_2d<std::uint8_t>& distance,
+                        bim::table_2d<position_on_grid>& previous,
+                        const entt::registry& registry, const arena& arena,
+                        const entity_world_map& entity_map,
+                        std::uint8_t from_x, std::uint8_t from_y,
+                        const bim::table_2d<bool>& allowed);
+    bool exists_bitboard(const entt::registry& registry, const arena& arena,
+                         const entity_world_map& entity_map,
+                         std::uint8_t from_x, std::uint8_t from_y,
+                         int max_distance,
+                         const bim::table_2d<bool>& forbidden);
+
     template <scan_loop_policy ScanLoopPolicy, typename Enter, typename Visit,
               typename Distance>
     void scan(const arena& arena, std::uint8_t from_x, std::uint8_t from_y,
               Enter&& enter, Visit&& visit, Distance&& distance);
 
   private:
+    algorithm m_algorithm;
+
     bim::table_2d<bool> m_queued;
     std::vector<position_on_grid> m_pending;
+
+    /**
+     * The revision of the arena for which m_moves have been built. The walls
+     * and fences do not change during a game, so the moves are built once
+     * per arena.
+     */
+    std::uint64_t m_moves_revision;
+
+    /// The width of the arena for which m_moves have been built.
+    std::uint8_t m_width;
+
+    /**
+     * For each direction (up, left, right, down), the cells from which we can
+     * move in this direction, considering only the static geometry.
+     */
+    std::array<cell_bitboard, 4> m_moves;
   };
 }
@@ -1,4 +1,6 @@
 // SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
 #include <bim/game/constant/max_player_count.hpp>
 
 #include <array>
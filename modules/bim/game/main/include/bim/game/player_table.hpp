@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/game/per_player_array.hpp>
+
+#include <entt/entity/fwd.hpp>
+
+#include <cstdint>
+
+namespace bim::game
+{
+  struct fractional_position_on_grid;
+  struct player;
+  struct player_action;
+  struct player_action_queue;
+
+  /**
+   * The players of a registry, with the components used by the movement
+   * systems, in contiguous arrays of at most g_max_player_count entries. The
+   * entries are in the iteration order of the registry.
+   *
+   * The components remain in the registry, such that the serialization, the
+   * checksums, and the other systems are not affected. The table keeps their
+   * addresses, and is rebuilt on the next call to refresh() when one of
+   * these components is created or destroyed. This covers
+   * deserialize_state() and game_state_snapshot::restore(), which both go
+   * through the storages of the registry.
+   */
+  class player_table
+  {
+  public:
+    explicit player_table(entt::registry& registry);
+    ~player_table();
+
+    player_table(const player_table&) = delete;
+    player_table& operator=(const player_table&) = delete;
+
+    /// Rebuild the table if the players have changed since the last call.
+    void refresh();
+
+    std::uint8_t size() const;
+
+  public:
+    per_player_array<entt::entity> entities;
+    per_player_array<player*> players;
+    per_player_array<fractional_position_on_grid*> positions;
+    per_player_array<player_action*> actions;
+    per_player_array<player_action_queue*> action_queues;
+
+  private:
+    void invalidate(entt::registry& registry, entt::entity e);
+
+  private:
+    entt::registry& m_registry;
+    std::uint8_t m_size;
+    bool m_dirty;
+  };
+}
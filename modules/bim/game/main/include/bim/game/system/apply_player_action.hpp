@@ -8,8 +8,14 @@ namespace bim::game
   class arena;
   class context;
   class entity_world_map;
+  class player_table;
 
   void apply_player_action(const context& context, entt::registry& registry,
                            const arena& arena,
                            bim::game::entity_world_map& entity_map);
+
+  /// Same as above, with the players taken from the given table.
+  void apply_player_action(const context& context, player_table& players,
+                           entt::registry& registry, const arena& arena,
+                           bim::game::entity_world_map& entity_map);
 }
@@ -3,19 +3,26 @@
 
 #include <entt/entity/fwd.hpp>
 
-#include <vector>
+#include <memory>
 
 namespace bim::game
 {
   class arena;
-  struct position_on_grid;
+  class arena_fall_order;
 
   class arena_reduction
   {
   public:
+    /// Compute the fall order for the given arena.
     explicit arena_reduction(const arena& arena);
+
+    /// Use a fall order computed elsewhere, which must outlive this system.
+    explicit arena_reduction(const arena_fall_order& fall_order);
+
     ~arena_reduction();
 
+    const arena_fall_order& fall_order() const;
+
     /**
      * Decrease the timer.
      * If zero, pop a block, increment index_of_next_fall, set
@@ -24,6 +31,8 @@ namespace bim::game
     void update(entt::registry& registry) const;
 
   private:
-    std::vector<position_on_grid> m_fall_order;
+    /// Set when the fall order is not shared.
+    const std::unique_ptr<const arena_fall_order> m_own_fall_order;
+    const arena_fall_order& m_fall_order;
   };
 }
@@ -8,8 +8,10 @@
 
 #include <entt/entity/fwd.hpp>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
+#include <vector>
 
 namespace bim::game
 {
@@ -24,6 +26,12 @@ namespace bim::game
     {
       bim::table_2d<bim::game::timer*> timer;
       bim::table_2d<fog_of_war*> fog;
+
+      /**
+       * One bit per cell, in row-major order, set for the fogs whose state or
+       * opacity changes in the current update.
+       */
+      std::vector<std::uint64_t> active;
     };
   }
 
@@ -42,15 +50,14 @@ namespace bim::game
                     int player_x, int player_y);
     void build_maps(entt::registry& registry);
 
-    void uncover_around_player(const detail::fog_properties& p, int player_x,
-                               int player_y) const;
     void uncover_around_flames(entt::registry& registry,
-                               const detail::fog_properties& p);
+                               detail::fog_properties& p);
 
     void update_opacity_from_timers(const detail::fog_properties& p) const;
 
   private:
-    bim::table_2d<bool> m_blown;
+    /// One bit per cell, set for the cells with a flame.
+    std::vector<std::uint64_t> m_blown;
     std::array<detail::fog_properties, g_max_player_count> m_tables;
 
     const std::uint8_t m_player_count;
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace bim::game
+{
+  enum class system_id : std::uint8_t
+  {
+#define bim_game_x_system(n) n,
+#include <bim/game/for_each_system.hpp>
+    count
+  };
+
+  std::string_view system_name(system_id id);
+
+  /// Cumulative execution time and call count of the systems of a contest.
+  struct system_timings
+  {
+    static constexpr std::size_t system_count =
+        (std::size_t)system_id::count;
+
+    system_timings();
+
+    system_timings& operator+=(const system_timings& that);
+
+    std::array<std::chrono::nanoseconds, system_count> duration;
+    std::array<std::uint64_t, system_count> calls;
+  };
+}
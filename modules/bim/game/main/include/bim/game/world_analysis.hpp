@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/game/component/position_on_grid.hpp>
+
+#include <bim/table_2d.hpp>
+
+#include <entt/core/fwd.hpp>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bim::game
+{
+  class contest;
+
+  /**
+   * The objects of a contest the bots care about, ignoring the fog of war.
+   * This is meant to be updated once per tick and shared by all the bots of
+   * the contest, each bot then keeping only what it can actually see.
+   */
+  class world_analysis
+  {
+  public:
+    struct bomb_info
+    {
+      position_on_grid position;
+      std::uint8_t strength;
+
+      /// Tells if the bomb is about to explode.
+      bool near_explosion;
+
+      /**
+       * The range in blast_cells() of the cells reached by the explosion of
+       * the bomb, including the cell of the bomb.
+       */
+      std::uint32_t blast_begin;
+      std::uint32_t blast_end;
+    };
+
+  public:
+    world_analysis(std::uint8_t arena_width, std::uint8_t arena_height);
+    ~world_analysis();
+
+    void update(const contest& contest);
+
+    std::span<const position_on_grid> crates() const;
+    const bim::table_2d<bool>& crate_map() const;
+    const bim::table_2d<bool>& solid_map() const;
+    std::span<const position_on_grid> flames() const;
+    std::span<const position_on_grid> falling_blocks() const;
+
+    /// The cells where the next blocks are going to fall, in order.
+    std::span<const position_on_grid> upcoming_falls() const;
+
+    const bim::table_2d<entt::id_type>& power_up_map() const;
+
+    /// The bombs, in the iteration order of the registry.
+    std::span<const bomb_info> bombs() const;
+    std::span<const position_on_grid> blast_cells(const bomb_info& b) const;
+
+  private:
+    void build_crates(const contest& contest);
+    void build_solid_map(const contest& contest);
+    void build_dangers(const contest& contest);
+    void build_power_up_map(const contest& contest);
+
+  private:
+    std::vector<position_on_grid> m_crates;
+    bim::table_2d<bool> m_crate_map;
+    bim::table_2d<bool> m_solid_map;
+    std::vector<position_on_grid> m_flames;
+    std::vector<position_on_grid> m_falling_blocks;
+    std::vector<position_on_grid> m_upcoming_falls;
+    bim::table_2d<entt::id_type> m_power_up_map;
+    std::vector<bomb_info> m_bombs;
+    std::vector<position_on_grid> m_blast_cells;
+  };
+}
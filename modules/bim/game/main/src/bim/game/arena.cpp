@@ -7,11 +7,24 @@
 #include <bim/assume.hpp>
 #include <bim/table_2d.impl.hpp>
 
-bim::game::arena::arena() = default;
+#include <atomic>
+
+/// A new value for arena::revision(). The arenas may be modified by many
+/// threads, e.g. in the server.
+static std::uint64_t new_revision()
+{
+  static std::atomic<std::uint64_t> g_next_revision(1);
+  return g_next_revision.fetch_add(1, std::memory_order_relaxed);
+}
+
+bim::game::arena::arena()
+  : m_revision(new_revision())
+{}
 
 bim::game::arena::arena(std::uint8_t width, std::uint8_t height)
   : m_width(width)
   , m_height(height)
+  , m_revision(new_revision())
   , m_is_static_wall(width, height, false)
   , m_fences(width, height, cell_edge::none)
 {
@@ -29,6 +42,21 @@ bim::game::arena&
 bim::game::arena::operator=(const arena& that) noexcept = default;
 bim::game::arena& bim::game::arena::operator=(arena&& that) noexcept = default;
 
+void bim::game::arena::reset(std::uint8_t width, std::uint8_t height)
+{
+  m_width = width;
+  m_height = height;
+  m_revision = new_revision();
+
+  m_is_static_wall.resize(width, height);
+  m_is_static_wall.fill(false);
+
+  m_fences.resize(width, height);
+  m_fences.fill(cell_edge::none);
+
+  m_static_walls.clear();
+}
+
 std::uint8_t bim::game::arena::width() const
 {
   return m_width;
@@ -57,6 +85,7 @@ void bim::game::arena::set_static_wall(std::uint8_t x, std::uint8_t y,
 
   m_static_walls.emplace_back(static_wall{ x, y, n });
   m_is_static_wall(x, y) = true;
+  m_revision = new_revision();
 }
 
 bim::game::cell_edge bim::game::arena::fences(std::uint8_t x,
@@ -69,6 +98,7 @@ void bim::game::arena::add_fence(std::uint8_t x, std::uint8_t y, cell_edge e)
 {
   assert(!m_is_static_wall(x, y));
   m_fences(x, y) |= e;
+  m_revision = new_revision();
 }
 
 void bim::game::arena::remove_fence(std::uint8_t x, std::uint8_t y,
@@ -76,4 +106,10 @@ void bim::game::arena::remove_fence(std::uint8_t x, std::uint8_t y,
 {
   assert(!m_is_static_wall(x, y));
   m_fences(x, y) &= ~e;
+  m_revision = new_revision();
+}
+
+std::uint64_t bim::game::arena::revision() const
+{
+  return m_revision;
 }
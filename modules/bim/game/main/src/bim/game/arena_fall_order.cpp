@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/arena_fall_order.hpp>
+
+#include <bim/game/arena.hpp>
+#include <bim/game/level_generation.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+bim::game::arena_fall_order::arena_fall_order(const arena& arena)
+{
+  const int width = arena.width();
+  const int height = arena.height();
+  std::vector<std::uint8_t> availability(width * height);
+  std::size_t free_count = 0;
+
+  for (int y = 0; y != height; ++y)
+    for (int x = 0; x != width; ++x)
+      {
+        const bool is_free = !arena.is_static_wall(x, y);
+        free_count += is_free;
+        availability[y * width + x] = is_free;
+      }
+
+  m_positions.reserve(free_count);
+
+  int horizontal_first = 0;
+  int horizontal_last = width - 1;
+  int vertical_first = 0;
+  int vertical_last = height - 1;
+
+  const auto horizontal_scan = [this, width, &availability](int y, int first,
+                                                            int last) -> int
+    {
+      const int inc = (last < first) ? -1 : 1;
+      const int n = inc * (last - first) + 1;
+
+      for (int i = 0; i != n; ++i, first += inc)
+        if (availability[y * width + first])
+          {
+            m_positions.emplace_back(first, y);
+            availability[y * width + first] = false;
+            return 1;
+          }
+
+      return 0;
+    };
+
+  const auto vertical_scan = [this, width, &availability](int x, int first,
+                                                          int last) -> int
+    {
+      const int inc = (last < first) ? -1 : 1;
+      const int n = inc * (last - first) + 1;
+
+      for (int i = 0; i != n; ++i, first += inc)
+        if (availability[first * width + x])
+          {
+            m_positions.emplace_back(x, first);
+            availability[first * width + x] = false;
+            return 1;
+          }
+
+      return 0;
+    };
+
+  while ((vertical_first <= vertical_last)
+         && (horizontal_first <= horizontal_last))
+    {
+      int added_count =
+          horizontal_scan(vertical_first, horizontal_first, horizontal_last);
+      added_count +=
+          vertical_scan(horizontal_last, vertical_first, vertical_last);
+      added_count +=
+          horizontal_scan(vertical_last, horizontal_last, horizontal_first);
+      added_count +=
+          vertical_scan(horizontal_first, vertical_last, vertical_first);
+
+      if (added_count == 0)
+        {
+          ++vertical_first;
+          --vertical_last;
+          ++horizontal_first;
+          --horizontal_last;
+        }
+    }
+}
+
+bim::game::arena_fall_order::~arena_fall_order() = default;
+
+std::span<const bim::game::position_on_grid>
+bim::game::arena_fall_order::positions() const
+{
+  return m_positions;
+}
+
+const bim::game::arena_fall_order&
+bim::game::basic_arena_fall_order(std::uint8_t width, std::uint8_t height)
+{
+  // The entries are never removed, so the references stay valid after the
+  // lock is released.
+  static std::mutex mutex;
+  static std::map<std::pair<std::uint8_t, std::uint8_t>,
+                  std::unique_ptr<const arena_fall_order>>
+      orders;
+
+  const std::lock_guard<std::mutex> lock(mutex);
+  std::unique_ptr<const arena_fall_order>& result =
+      orders[std::make_pair(width, height)];
+
+  if (!result)
+    {
+      arena arena(width, height);
+      generate_basic_level_structure(arena);
+      result.reset(new arena_fall_order(arena));
+    }
+
+  return *result;
+}
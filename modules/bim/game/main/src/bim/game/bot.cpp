@@ -3,12 +3,8 @@
 
 #include <bim/game/arena.hpp>
 #include <bim/game/component/animation_state.hpp>
-#include <bim/game/component/bomb.hpp>
 #include <bim/game/component/bomb_power_up.hpp>
 #include <bim/game/component/clock.hpp>
-#include <bim/game/component/crate.hpp>
-#include <bim/game/component/falling_block.hpp>
-#include <bim/game/component/flame.hpp>
 #include <bim/game/component/flame_power_up.hpp>
 #include <bim/game/component/fog_of_war.hpp>
 #include <bim/game/component/fractional_position_on_grid.hpp>
@@ -19,12 +15,8 @@
 #include <bim/game/component/player_action.hpp>
 #include <bim/game/component/player_action_queue.hpp>
 #include <bim/game/component/player_movement.hpp>
-#include <bim/game/component/power_up.hpp>
 #include <bim/game/component/shield.hpp>
 #include <bim/game/component/shield_power_up.hpp>
-#include <bim/game/component/solid.hpp>
-#include <bim/game/component/timer.hpp>
-#include <bim/game/constant/bomb_near_explosion_duration.hpp>
 #include <bim/game/contest.hpp>
 #include <bim/game/context/context.hpp>
 #include <bim/game/context/player_animations.hpp>
@@ -42,6 +34,7 @@
 #include <entt/core/type_info.hpp>
 #include <entt/entity/registry.hpp>
 
+#include <algorithm>
 #include <format>
 #include <type_traits>
 
@@ -63,6 +56,15 @@ enum class bim::game::bot::state : std::uint8_t
   reach_for_safety
 };
 
+enum class bim::game::bot::goal_search : std::uint8_t
+{
+  found,
+  failed,
+
+  /// The budget has been consumed before the end of the search.
+  pending
+};
+
 bim::game::bot::goal::goal(int x, int y)
   : target(x, y)
   , drop_bomb(false)
@@ -82,7 +84,11 @@ bim::game::bot::bot(std::uint8_t player_index, std::uint8_t arena_width,
   , m_power_up_map(arena_width, arena_height)
   , m_distance(arena_width, arena_height)
   , m_previous_cell(arena_width, arena_height)
+  , m_goal_search_cell(0)
+  , m_goal_search_best_reward(0)
+  , m_think_budget(0)
   , m_random(seed)
+  , m_world_analysis(arena_width, arena_height)
   , m_state(state::start)
   , m_player_index(player_index)
   , m_log(nullptr)
@@ -117,7 +123,19 @@ std::uint8_t bim::game::bot::player_index() const
   return m_player_index;
 }
 
+void bim::game::bot::think_budget(std::uint16_t cell_count)
+{
+  m_think_budget = cell_count;
+}
+
 bim::game::player_action bim::game::bot::think(const contest& contest)
+{
+  m_world_analysis.update(contest);
+  return think(contest, m_world_analysis);
+}
+
+bim::game::player_action bim::game::bot::think(const contest& contest,
+                                               const world_analysis& world)
 {
   ZoneScoped;
 
@@ -153,10 +171,12 @@ bim::game::player_action bim::game::bot::think(const contest& contest)
   bim_assume(queued_bot_actions);
 
   const int unknown_count = build_visibility_map(contest);
-  const int crate_count = build_crate_map(contest);
-  build_solid_map(contest);
-  build_danger_map(contest, *bot_player, *queued_bot_actions);
-  build_power_up_map(contest);
+  const bool full_visibility = unknown_count == 0;
+  const int crate_count = build_crate_map(world, full_visibility);
+  build_solid_map(world, full_visibility);
+  build_danger_map(contest, world, full_visibility, *bot_player,
+                   *queued_bot_actions);
+  build_power_up_map(world, full_visibility);
 
   const position_on_grid& bot_position = player_positions[m_player_index];
   bool skip_find_goal = false;
@@ -195,16 +215,36 @@ bim::game::player_action bim::game::bot::think(const contest& contest)
         }
     }
 
+  // An interrupted search is resumed even if we have a goal, since this goal
+  // is only the best one found so far.
   if (!skip_find_goal
-      && (!m_goal || !goal_is_feasible(contest, *bot_player, bot_position)))
+      && (!m_goal || (m_goal_search_cell != 0)
+          || !goal_is_feasible(contest, *bot_player, bot_position)))
     {
-      if (!find_goal(contest, opponent_is_valid, player_positions, *bot_player,
-                     crate_count, unknown_count))
-        return player_action{};
-
-      store_goal_path();
-      log_goal();
+      switch (find_goal(contest, opponent_is_valid, player_positions,
+                        *bot_player, crate_count, unknown_count))
+        {
+        case goal_search::found:
+          store_goal_path();
+          log_goal();
+          break;
+        case goal_search::failed:
+          return player_action{};
+        case goal_search::pending:
+          // Go toward the best candidate found so far until the search
+          // completes.
+          if (!select_pending_goal())
+            return player_action{};
+
+          store_goal_path();
+          log_goal();
+          break;
+        }
     }
+  else
+    // The safety goal has been updated, the candidates of an interrupted
+    // search are outdated.
+    m_goal_search_cell = 0;
 
   return action_toward_goal(contest, *bot_player, *queued_bot_actions,
                             opponent_is_valid, player_positions,
@@ -288,42 +328,52 @@ int bim::game::bot::build_visibility_map(const contest& contest)
   return result;
 }
 
-int bim::game::bot::build_crate_map(const contest& contest)
+int bim::game::bot::build_crate_map(const world_analysis& world,
+                                    bool full_visibility)
 {
-  m_crate_map.fill(false);
-  int result = 0;
+  int result;
 
-  contest.registry().view<crate, position_on_grid>().each(
-      [this, &result](const position_on_grid& p)
-        {
-          if (m_visibility_map(p.x, p.y))
-            {
-              m_crate_map(p.x, p.y) = true;
-              ++result;
-            }
-        });
+  if (full_visibility)
+    {
+      m_crate_map = world.crate_map();
+      result = world.crates().size();
+    }
+  else
+    {
+      m_crate_map.fill(false);
+      result = 0;
+
+      for (const position_on_grid& p : world.crates())
+        if (m_visibility_map(p.x, p.y))
+          {
+            m_crate_map(p.x, p.y) = true;
+            ++result;
+          }
+    }
 
   log_map("crate_map", m_crate_map);
 
   return result;
 }
 
-void bim::game::bot::build_solid_map(const contest& contest)
+void bim::game::bot::build_solid_map(const world_analysis& world,
+                                     bool full_visibility)
 {
-  m_solid_map.fill(false);
+  const bim::table_2d<bool>& solid_map = world.solid_map();
 
-  contest.registry().view<solid, position_on_grid>().each(
-      [this](const position_on_grid& p)
-        {
-          m_solid_map(p.x, p.y) = m_visibility_map(p.x, p.y);
-        });
+  if (full_visibility)
+    m_solid_map = solid_map;
+  else
+    for (std::size_t y = 0, h = m_solid_map.height(); y != h; ++y)
+      for (std::size_t x = 0, w = m_solid_map.width(); x != w; ++x)
+        m_solid_map(x, y) = solid_map(x, y) && m_visibility_map(x, y);
 
   log_map("solid_map", m_solid_map);
 }
 
 void bim::game::bot::build_danger_map(
-    const contest& contest, const player& bot_player,
-    const player_action_queue& queued_actions)
+    const contest& contest, const world_analysis& world, bool full_visibility,
+    const player& bot_player, const player_action_queue& queued_actions)
 {
   // If we can't tell what's in the cell then its a potential danger.
   for (std::size_t y = 0, h = m_visibility_map.height(); y != h; ++y)
@@ -333,36 +383,34 @@ void bim::game::bot::build_danger_map(
       }
 
   // All flames are a danger.
-  contest.registry().view<flame, position_on_grid>().each(
-      [this](const flame&, const position_on_grid& p)
-        {
-          m_death_map(p.x, p.y) = true;
-        });
+  for (const position_on_grid& p : world.flames())
+    m_death_map(p.x, p.y) = true;
 
   m_immediate_danger_map = m_death_map;
 
   // Falling blocks are a danger.
-  contest.registry().view<falling_block, position_on_grid>().each(
-      [this](const position_on_grid& p)
-        {
-          m_immediate_danger_map(p.x, p.y) = true;
-        });
+  for (const position_on_grid& p : world.falling_blocks())
+    m_immediate_danger_map(p.x, p.y) = true;
 
   // First pass on the bombs to simulate the blast of the bombs on the verge of
   // exploding.
-  contest.registry().view<bomb, position_on_grid, timer>().each(
-      [this, &contest](const bomb& b, const position_on_grid& p,
-                       const timer& t)
-        {
-          if (!m_visibility_map(p.x, p.y))
-            return;
+  for (const world_analysis::bomb_info& b : world.bombs())
+    {
+      if (!m_visibility_map(b.position.x, b.position.y))
+        continue;
 
-          if (t.duration <= g_bomb_near_explosion_duration)
-            store_bomb_danger(m_immediate_danger_map, contest, p, b.strength);
-        });
+      if (b.near_explosion)
+        store_bomb_danger(m_immediate_danger_map, contest, world, b,
+                          full_visibility);
+    }
 
   m_danger_map = m_immediate_danger_map;
 
+  // The blocks about to fall are a danger too. Their positions are known in
+  // advance, whatever the visibility.
+  for (const position_on_grid& p : world.upcoming_falls())
+    m_danger_map(p.x, p.y) = true;
+
   // Now we consider that a bomb located on an immediate danger (i.e. a bomb
   // that is going to be crushed, or in the blast of another bomb), is also an
   // immediate danger.
@@ -380,61 +428,37 @@ void bim::game::bot::build_danger_map(
                             bot_player.bomb_strength);
       }
 
-  contest.registry().view<bomb, position_on_grid, timer>().each(
-      [this, &contest](const bomb& b, const position_on_grid& p,
-                       const timer& t)
-        {
-          if (!m_visibility_map(p.x, p.y))
-            return;
+  for (const world_analysis::bomb_info& b : world.bombs())
+    {
+      if (!m_visibility_map(b.position.x, b.position.y))
+        continue;
 
-          store_bomb_danger(m_danger_map, contest, p, b.strength);
+      store_bomb_danger(m_danger_map, contest, world, b, full_visibility);
 
-          // No need to simulate bombs near explosion, it's already done above.
-          if (m_immediate_danger_map(p.x, p.y)
-              && (t.duration > g_bomb_near_explosion_duration))
-            store_bomb_danger(m_immediate_danger_map, contest, p, b.strength);
-        });
+      // No need to simulate bombs near explosion, it's already done above.
+      if (m_immediate_danger_map(b.position.x, b.position.y)
+          && !b.near_explosion)
+        store_bomb_danger(m_immediate_danger_map, contest, world, b,
+                          full_visibility);
+    }
 
   log_map("danger_map", m_danger_map);
   log_map("immediate_danger_map", m_immediate_danger_map);
   log_map("death_map", m_death_map);
 }
 
-void bim::game::bot::build_power_up_map(const contest& contest)
+void bim::game::bot::build_power_up_map(const world_analysis& world,
+                                        bool full_visibility)
 {
-  m_power_up_map.fill(g_type_void);
-
-  const entt::registry& registry = contest.registry();
-
-  const entt::registry::storage_for_type<bomb_power_up>* const bomb_power_ups =
-      registry.storage<bomb_power_up>();
-  const entt::registry::storage_for_type<flame_power_up>* const
-      flame_power_ups = registry.storage<flame_power_up>();
-  const entt::registry::storage_for_type<shield_power_up>* const
-      shield_power_ups = registry.storage<shield_power_up>();
-  const entt::registry::storage_for_type<invisibility_power_up>* const
-      invisibility_power_ups = registry.storage<invisibility_power_up>();
-
-  const auto contains = [&](const auto* storage, entt::entity e) -> bool
-    {
-      return storage && storage->contains(e);
-    };
+  const bim::table_2d<entt::id_type>& power_up_map = world.power_up_map();
 
-  contest.registry().view<power_up, position_on_grid>().each(
-      [&](entt::entity e, const position_on_grid& p)
-        {
-          if (!m_visibility_map(p.x, p.y))
-            return;
-
-          if (contains(bomb_power_ups, e))
-            m_power_up_map(p.x, p.y) = g_type_bomb_power_up;
-          else if (contains(flame_power_ups, e))
-            m_power_up_map(p.x, p.y) = g_type_flame_power_up;
-          else if (contains(shield_power_ups, e))
-            m_power_up_map(p.x, p.y) = g_type_shield_power_up;
-          else if (contains(invisibility_power_ups, e))
-            m_power_up_map(p.x, p.y) = g_type_invisibility_power_up;
-        });
+  if (full_visibility)
+    m_power_up_map = power_up_map;
+  else
+    for (std::size_t y = 0, h = m_power_up_map.height(); y != h; ++y)
+      for (std::size_t x = 0, w = m_power_up_map.width(); x != w; ++x)
+        m_power_up_map(x, y) =
+            m_visibility_map(x, y) ? power_up_map(x, y) : g_type_void;
 
   log_map("power_up_map", m_power_up_map);
 }
@@ -453,6 +477,20 @@ void bim::game::bot::store_bomb_danger(bim::table_2d<bool>& map,
                             });
 }
 
+void bim::game::bot::store_bomb_danger(
+    bim::table_2d<bool>& map, const contest& contest,
+    const world_analysis& world, const world_analysis::bomb_info& bomb,
+    bool full_visibility)
+{
+  // The blast in the world analysis has been computed with all the solids,
+  // which is what we see if there is no fog.
+  if (full_visibility)
+    for (const position_on_grid& p : world.blast_cells(bomb))
+      map(p.x, p.y) = true;
+  else
+    store_bomb_danger(map, contest, bomb.position, bomb.strength);
+}
+
 bool bim::game::bot::goal_is_feasible(const contest& contest,
                                       const player& bot_player,
                                       const position_on_grid& bot_position)
@@ -537,13 +575,11 @@ bool bim::game::bot::goal_is_feasible(const contest& contest,
   return feasible;
 }
 
-bool bim::game::bot::find_goal(
+bim::game::bot::goal_search bim::game::bot::find_goal(
     const contest& contest, const per_player_array<bool>& opponent_is_valid,
     const per_player_array<position_on_grid>& player_positions,
     const player& bot_player, int crate_count, int unknown_count)
 {
-  m_goal = std::nullopt;
-
   const position_on_grid& bot_position = player_positions[m_player_index];
 
   m_navigation.paths(m_distance, m_previous_cell, contest.registry(),
@@ -552,14 +588,22 @@ bool bim::game::bot::find_goal(
 
   log_map("distances", m_distance);
 
-  if (m_state == state::reach_for_safety)
-    return find_safety_goal();
-
-  if ((crate_count > 0) || (unknown_count > 0))
+  if ((m_state != state::reach_for_safety)
+      && ((crate_count > 0) || (unknown_count > 0)))
     return find_exploration_goal(contest, opponent_is_valid, player_positions,
                                  bot_player);
 
-  return find_attack_goal(opponent_is_valid, player_positions);
+  // Only the exploration is searched incrementally, the other goals are
+  // cheap.
+  m_goal_search_cell = 0;
+  m_goal = std::nullopt;
+
+  const bool found = (m_state == state::reach_for_safety)
+                         ? find_safety_goal()
+                         : find_attack_goal(opponent_is_valid,
+                                            player_positions);
+
+  return found ? goal_search::found : goal_search::failed;
 }
 
 bool bim::game::bot::find_safety_goal()
@@ -666,12 +710,20 @@ bool bim::game::bot::update_safety_goal(const contest& contest,
   return true;
 }
 
-bool bim::game::bot::find_exploration_goal(
+bim::game::bot::goal_search bim::game::bot::find_exploration_goal(
     const contest& contest, const per_player_array<bool>& opponent_is_valid,
     const per_player_array<position_on_grid>& player_positions,
     const player& bot_player)
 {
-  log_event("New goal: exploration.");
+  if (m_goal_search_cell == 0)
+    {
+      log_event("New goal: exploration.");
+      m_candidate_goals.clear();
+      m_goal_search_best_reward = std::numeric_limits<int>::min();
+    }
+  else
+    log_event("Resume goal: exploration.");
+
   const entt::registry& registry = contest.registry();
 
   bool in_open_area = false;
@@ -701,46 +753,94 @@ bool bim::game::bot::find_exploration_goal(
     fprintf(m_log, "exploration target, has_shield=%d, in_open_area=%d\n",
             has_shield, in_open_area);
 
-  m_candidate_goals.clear();
-  int best_reward = std::numeric_limits<int>::min();
+  const std::size_t width = m_distance.width();
+  const std::size_t cell_count = width * m_distance.height();
+  std::size_t budget = (m_think_budget == 0) ? cell_count : m_think_budget;
 
   // Check what can be done in each reachable cell and select the most
   // interesting goal.
-  for (std::size_t y = 0, h = m_distance.height(); y != h; ++y)
-    for (std::size_t x = 0, w = m_distance.width(); x != w; ++x)
-      {
-        if (m_distance(x, y) >= navigation_check::unreachable)
-          continue;
+  for (; m_goal_search_cell != cell_count; ++m_goal_search_cell)
+    {
+      const std::size_t x = m_goal_search_cell % width;
+      const std::size_t y = m_goal_search_cell / width;
+
+      if (m_distance(x, y) >= navigation_check::unreachable)
+        continue;
 
-        int cell_reward;
-        const goal g = analyze_cell(cell_reward, contest, opponent_is_valid,
-                                    player_positions, bot_player, has_shield,
-                                    in_open_area, x, y);
+      if (budget == 0)
+        {
+          log_event("Exploration: out of budget.");
+          return goal_search::pending;
+        }
+
+      --budget;
 
-        if (cell_reward < best_reward)
+      int cell_reward;
+      const goal g = analyze_cell(cell_reward, contest, opponent_is_valid,
+                                  player_positions, bot_player, has_shield,
+                                  in_open_area, x, y);
+
+      if (cell_reward < m_goal_search_best_reward)
+        continue;
+
+      if (cell_reward == m_goal_search_best_reward)
+        {
+          m_candidate_goals.push_back(g);
           continue;
+        }
 
-        if (cell_reward == best_reward)
-          {
-            m_candidate_goals.push_back(g);
-            continue;
-          }
+      m_goal_search_best_reward = cell_reward;
+      m_candidate_goals.clear();
+      m_candidate_goals.push_back(g);
+    }
 
-        best_reward = cell_reward;
-        m_candidate_goals.clear();
-        m_candidate_goals.push_back(g);
-      }
+  m_goal_search_cell = 0;
+
+  // The candidates found in the previous calls may not be reachable anymore.
+  std::erase_if(m_candidate_goals,
+                [this](const goal& g) -> bool
+                  {
+                    return m_distance(g.target.x, g.target.y)
+                           >= navigation_check::unreachable;
+                  });
+
+  m_goal = std::nullopt;
 
   if (m_candidate_goals.empty())
-    log_event("Exploration: no candidate goal.");
-  else
     {
-      std::uniform_int_distribution<std::size_t> d(0, m_candidate_goals.size()
-                                                          - 1);
-      m_goal = m_candidate_goals[d(m_random)];
+      log_event("Exploration: no candidate goal.");
+      return goal_search::failed;
     }
 
-  return !!m_goal;
+  std::uniform_int_distribution<std::size_t> d(0, m_candidate_goals.size()
+                                                      - 1);
+  m_goal = m_candidate_goals[d(m_random)];
+
+  return goal_search::found;
+}
+
+bool bim::game::bot::select_pending_goal()
+{
+  // The candidates found in the previous calls may not be reachable anymore.
+  // The random generator is not used here, such that the goal selected when
+  // the search completes is the same than without a budget.
+  const std::vector<goal>::const_iterator it =
+      std::find_if(m_candidate_goals.begin(), m_candidate_goals.end(),
+                   [this](const goal& g) -> bool
+                     {
+                       return m_distance(g.target.x, g.target.y)
+                              < navigation_check::unreachable;
+                     });
+
+  if (it == m_candidate_goals.end())
+    {
+      log_event("Exploration: no pending candidate goal.");
+      m_goal = std::nullopt;
+      return false;
+    }
+
+  m_goal = *it;
+  return true;
 }
 
 bool bim::game::bot::find_attack_goal(
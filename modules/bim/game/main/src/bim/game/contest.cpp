@@ -2,6 +2,7 @@
 #include <bim/game/contest.hpp>
 
 #include <bim/game/arena.hpp>
+#include <bim/game/arena_fall_order.hpp>
 #include <bim/game/check_game_over.hpp>
 #include <bim/game/component/player.hpp>
 #include <bim/game/component/player_action.hpp>
@@ -9,8 +10,8 @@
 #include <bim/game/contest_fingerprint.hpp>
 #include <bim/game/contest_result.hpp>
 #include <bim/game/context/context.hpp>
-#include <bim/game/context/fill_context.hpp>
 #include <bim/game/context/player_animations.hpp>
+#include <bim/game/context/shared_context.hpp>
 #include <bim/game/entity_world_map.hpp>
 #include <bim/game/factory/arena_reduction.hpp>
 #include <bim/game/factory/fog_of_war.hpp>
@@ -18,6 +19,8 @@
 #include <bim/game/factory/main_timer.hpp>
 #include <bim/game/factory/player.hpp>
 #include <bim/game/feature_flags.hpp>
+#include <bim/game/game_state_checksum.hpp>
+#include <bim/game/player_table.hpp>
 #include <bim/game/system/animator.hpp>
 #include <bim/game/system/apply_player_action.hpp>
 #include <bim/game/system/arena_reduction.hpp>
@@ -43,6 +46,7 @@
 
 #include <bim/game/level_generation.hpp>
 #include <bim/game/random_generator.hpp>
+#include <bim/game/system_timings.hpp>
 
 #include <bim/assume.hpp>
 #include <bim/tracy.hpp>
@@ -61,6 +65,37 @@ namespace bim::game
   class shield_power_up_spawner;
 }
 
+namespace
+{
+  class scoped_system_timer
+  {
+  public:
+    scoped_system_timer(bim::game::system_timings* timings,
+                        bim::game::system_id id)
+      : m_timings(timings)
+      , m_index((std::size_t)id)
+    {
+      if (m_timings)
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    ~scoped_system_timer()
+    {
+      if (!m_timings)
+        return;
+
+      m_timings->duration[m_index] +=
+          std::chrono::steady_clock::now() - m_start;
+      ++m_timings->calls[m_index];
+    }
+
+  private:
+    bim::game::system_timings* const m_timings;
+    const std::size_t m_index;
+    std::chrono::steady_clock::time_point m_start;
+  };
+}
+
 constexpr std::chrono::milliseconds bim::game::contest::tick_interval;
 
 static std::vector<bim::game::position_on_grid>
@@ -161,16 +196,44 @@ static void add_fog_of_war(entt::registry& registry, std::uint8_t player_count,
 
 bim::game::contest::contest(const contest_fingerprint& fingerprint)
   : m_registry(new entt::registry())
-  , m_context(new bim::game::context())
+  , m_state_checksum(new incremental_game_state_checksum(*m_registry))
+  , m_context(shared_context())
   , m_arena(new bim::game::arena(fingerprint.arena_width,
                                  fingerprint.arena_height))
   , m_entity_world_map(new entity_world_map(fingerprint.arena_width,
                                             fingerprint.arena_height))
+  , m_players(new player_table(*m_registry))
+  , m_system_timings(nullptr)
 {
-  fill_context(*m_context);
+  generate(fingerprint);
+}
+
+bim::game::contest::~contest() = default;
+
+void bim::game::contest::reset(const contest_fingerprint& fingerprint)
+{
+  ZoneScoped;
+
+  // The storages keep their memory when cleared.
+  m_registry->clear();
 
+  // Clearing the registry only releases the entities, which would then be
+  // recycled with a new version. Clearing the storage of the entities too
+  // makes the next identifiers the same than in a new registry, such that
+  // the game is the same than in a new contest.
+  m_registry->storage<entt::entity>().clear();
+
+  m_arena->reset(fingerprint.arena_width, fingerprint.arena_height);
+  m_entity_world_map->reset(fingerprint.arena_width,
+                            fingerprint.arena_height);
+
+  generate(fingerprint);
+}
+
+void bim::game::contest::generate(const contest_fingerprint& fingerprint)
+{
   const std::vector<bim::game::position_on_grid> forbidden_positions =
-      add_players(*m_context, *m_registry, *m_entity_world_map,
+      add_players(m_context, *m_registry, *m_entity_world_map,
                   fingerprint.player_count, fingerprint.arena_width,
                   fingerprint.arena_height);
 
@@ -181,7 +244,7 @@ bim::game::contest::contest(const contest_fingerprint& fingerprint)
   if (!!(fingerprint.features & feature_flags::fences))
     insert_random_fences(*m_arena, random, forbidden_positions);
 
-  insert_random_crates(*m_context, *m_arena, *m_entity_world_map, *m_registry,
+  insert_random_crates(m_context, *m_arena, *m_entity_world_map, *m_registry,
                        random, fingerprint.crate_probability,
                        fingerprint.features, forbidden_positions);
 
@@ -196,13 +259,12 @@ bim::game::contest::contest(const contest_fingerprint& fingerprint)
     add_fog_of_war(*m_registry, fingerprint.player_count,
                    fingerprint.arena_width, fingerprint.arena_height, random);
 
-  m_arena_reduction.reset(new arena_reduction(*m_arena));
+  m_arena_reduction.reset(new arena_reduction(basic_arena_fall_order(
+      fingerprint.arena_width, fingerprint.arena_height)));
   m_fog_of_war.reset(
       new fog_of_war_updater(*m_arena, fingerprint.player_count));
 }
 
-bim::game::contest::~contest() = default;
-
 const bim::table_2d<bim::game::fog_of_war*>&
 bim::game::contest::fog_map(std::size_t player_index) const
 {
@@ -216,36 +278,38 @@ bim::game::contest_result bim::game::contest::tick()
 #define run_system(n, call)                                                   \
   do                                                                          \
     {                                                                         \
-      ZoneScopedN(n);                                                         \
+      ZoneScopedN(#n);                                                        \
+      const scoped_system_timer system_timer(m_system_timings,                \
+                                             system_id::n);                   \
       call;                                                                   \
     }                                                                         \
   while (false)
 
-#define run_system_s(f, ...) run_system(#f, f(__VA_ARGS__))
-#define run_system_t(t, f, ...) run_system(#t, f<t>(__VA_ARGS__))
+#define run_system_s(f, ...) run_system(f, f(__VA_ARGS__))
+#define run_system_t(t, f, ...) run_system(t, f<t>(__VA_ARGS__))
 
   run_system_s(refresh_bomb_inventory, *m_registry);
   run_system_s(update_clocks, *m_registry, tick_interval);
   run_system_s(update_timers, *m_registry, tick_interval);
-  run_system_s(animator, *m_context, *m_registry, tick_interval);
+  run_system_s(animator, m_context, *m_registry, tick_interval);
 
-  run_system_s(apply_player_action, *m_context, *m_registry, *m_arena,
-               *m_entity_world_map);
+  run_system_s(apply_player_action, m_context, *m_players, *m_registry,
+               *m_arena, *m_entity_world_map);
 
-  run_system("arena_reduction", m_arena_reduction->update(*m_registry));
+  run_system(arena_reduction, m_arena_reduction->update(*m_registry));
   run_system_s(update_falling_blocks, *m_registry, *m_entity_world_map);
 
   run_system_s(trigger_crushed_timers, *m_registry);
 
-  run_system_s(update_bombs, *m_context, *m_registry, *m_arena,
+  run_system_s(update_bombs, m_context, *m_registry, *m_arena,
                *m_entity_world_map);
 
-  run_system_s(update_flames, *m_context, *m_registry, *m_entity_world_map);
+  run_system_s(update_flames, m_context, *m_registry, *m_entity_world_map);
   run_system_s(update_invincibility_state, *m_registry);
   run_system_s(update_shields, *m_registry);
 
-  run_system_s(update_crates, *m_context, *m_registry);
-  run_system_s(update_invisibility_state, *m_context, *m_registry);
+  run_system_s(update_crates, m_context, *m_registry);
+  run_system_s(update_invisibility_state, m_context, *m_registry);
 
   run_system_t(bomb_power_up_spawner, update_power_up_spawners, *m_registry,
                *m_entity_world_map);
@@ -263,8 +327,8 @@ bim::game::contest_result bim::game::contest::tick()
                *m_entity_world_map);
   run_system_s(update_shield_power_ups, *m_registry, *m_entity_world_map);
 
-  run_system_s(update_players, *m_context, *m_registry);
-  run_system("fog_of_war", m_fog_of_war->update(*m_registry));
+  run_system_s(update_players, m_context, *m_registry);
+  run_system(fog_of_war, m_fog_of_war->update(*m_registry));
 
   run_system_s(remove_dead_objects, *m_registry, *m_entity_world_map);
 
@@ -279,12 +343,22 @@ bim::game::contest_result bim::game::contest::tick()
         assert(m_registry->valid(e));
 #endif
 
-  return check_game_over(*m_context, *m_registry);
+  return check_game_over(m_context, *m_registry);
+}
+
+std::uint32_t bim::game::contest::state_checksum() const
+{
+  return m_state_checksum->value();
+}
+
+void bim::game::contest::measure_systems(bim::game::system_timings* timings)
+{
+  m_system_timings = timings;
 }
 
 const bim::game::context& bim::game::contest::context() const
 {
-  return *m_context;
+  return m_context;
 }
 
 entt::registry& bim::game::contest::registry()
@@ -302,6 +376,11 @@ const bim::game::arena& bim::game::contest::arena() const
   return *m_arena;
 }
 
+const bim::game::arena_fall_order& bim::game::contest::fall_order() const
+{
+  return m_arena_reduction->fall_order();
+}
+
 const bim::game::entity_world_map& bim::game::contest::entity_map() const
 {
   return *m_entity_world_map;
@@ -0,0 +1,40 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/contest_pool.hpp>
+
+#include <bim/game/contest.hpp>
+
+bim::game::contest_pool::contest_pool(std::size_t max_size)
+  : m_max_size(max_size)
+{
+  m_contests.reserve(max_size);
+}
+
+bim::game::contest_pool::~contest_pool() = default;
+
+std::unique_ptr<bim::game::contest>
+bim::game::contest_pool::acquire(const contest_fingerprint& fingerprint)
+{
+  if (m_contests.empty())
+    return std::make_unique<contest>(fingerprint);
+
+  std::unique_ptr<contest> result = std::move(m_contests.back());
+  m_contests.pop_back();
+
+  result->reset(fingerprint);
+
+  return result;
+}
+
+void bim::game::contest_pool::release(std::unique_ptr<contest> c)
+{
+  if (!c || (m_contests.size() == m_max_size))
+    return;
+
+  c->measure_systems(nullptr);
+  m_contests.push_back(std::move(c));
+}
+
+std::size_t bim::game::contest_pool::size() const
+{
+  return m_contests.size();
+}
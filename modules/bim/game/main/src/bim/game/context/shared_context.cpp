@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/context/shared_context.hpp>
+
+#include <bim/game/context/context.hpp>
+#include <bim/game/context/fill_context.hpp>
+
+namespace
+{
+  struct filled_context
+  {
+    filled_context()
+    {
+      bim::game::fill_context(context);
+    }
+
+    bim::game::context context;
+  };
+}
+
+const bim::game::context& bim::game::shared_context()
+{
+  // The initialization of a static local variable is thread-safe.
+  static const filled_context g_context;
+
+  return g_context.context;
+}
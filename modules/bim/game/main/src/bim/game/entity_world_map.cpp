@@ -1,17 +1,30 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #include <bim/game/entity_world_map.hpp>
 
-#include <entt/entity/registry.hpp>
+#include <bim/assume.hpp>
 
-#include <bim/table_2d.impl.hpp>
+#include <entt/entity/entity.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
-bim::game::entity_world_map::entity_world_map() = default;
+// Most cells contain at most a wall, a crate, a bomb, or a few players.
+static constexpr std::uint8_t g_initial_cell_capacity = 4;
+
+bim::game::entity_world_map::entity_world_map()
+  : m_width(0)
+  , m_height(0)
+  , m_cell_capacity(g_initial_cell_capacity)
+{}
 
 bim::game::entity_world_map::entity_world_map(std::uint8_t width,
                                               std::uint8_t height)
-  : m_entities(width, height)
+  : m_width(width)
+  , m_height(height)
+  , m_cell_capacity(g_initial_cell_capacity)
+  , m_entity_count(width * height, 0)
+  , m_entities(width * height * m_cell_capacity, entt::null)
 {}
 
 bim::game::entity_world_map::entity_world_map(const entity_world_map& that) =
@@ -26,33 +39,83 @@ bim::game::entity_world_map::operator=(const entity_world_map& that) = default;
 bim::game::entity_world_map& bim::game::entity_world_map::operator=(
     entity_world_map&& that) noexcept = default;
 
+void bim::game::entity_world_map::reset(std::uint8_t width,
+                                        std::uint8_t height)
+{
+  m_width = width;
+  m_height = height;
+
+  // Keep the current capacity of the cells, a previous game needed it, the
+  // next one probably will too.
+  m_entity_count.assign(width * height, 0);
+  m_entities.assign(width * height * m_cell_capacity, entt::null);
+}
+
 std::span<const entt::entity>
 bim::game::entity_world_map::entities_at(std::uint8_t x, std::uint8_t y) const
 {
-  return m_entities(x, y);
+  const std::size_t i = cell_index(x, y);
+
+  return std::span<const entt::entity>(
+      m_entities.data() + i * m_cell_capacity, m_entity_count[i]);
 }
 
 void bim::game::entity_world_map::put_entity(entt::entity e, std::uint8_t x,
                                              std::uint8_t y)
 {
 #ifndef NDEBUG
-  for (const entity_vector& v : m_entities)
-    assert(std::ranges::find(v, e) == v.end());
+  for (std::uint8_t cy = 0; cy != m_height; ++cy)
+    for (std::uint8_t cx = 0; cx != m_width; ++cx)
+      assert(std::ranges::find(entities_at(cx, cy), e)
+             == entities_at(cx, cy).end());
 #endif
 
-  m_entities(x, y).push_back(e);
+  const std::size_t i = cell_index(x, y);
+
+  if (m_entity_count[i] == m_cell_capacity)
+    grow_cells();
+
+  m_entities[i * m_cell_capacity + m_entity_count[i]] = e;
+  ++m_entity_count[i];
 }
 
 void bim::game::entity_world_map::erase_entity(entt::entity e, std::uint8_t x,
                                                std::uint8_t y)
 {
-  entity_vector& v = m_entities(x, y);
+  const std::size_t i = cell_index(x, y);
+  entt::entity* const begin = m_entities.data() + i * m_cell_capacity;
+  entt::entity* const end = begin + m_entity_count[i];
 
-  v.erase(std::remove(v.begin(), v.end(), e), v.end());
+  m_entity_count[i] = std::remove(begin, end, e) - begin;
 }
 
 void bim::game::entity_world_map::erase_entities(std::uint8_t x,
                                                  std::uint8_t y)
 {
-  m_entities(x, y).clear();
+  m_entity_count[cell_index(x, y)] = 0;
+}
+
+std::size_t bim::game::entity_world_map::cell_index(std::uint8_t x,
+                                                    std::uint8_t y) const
+{
+  bim_assume(x < m_width);
+  bim_assume(y < m_height);
+
+  return y * m_width + x;
+}
+
+void bim::game::entity_world_map::grow_cells()
+{
+  assert(m_cell_capacity <= std::numeric_limits<std::uint8_t>::max() / 2);
+
+  const std::uint8_t capacity = m_cell_capacity * 2;
+  const std::size_t cell_count = m_entity_count.size();
+  std::vector<entt::entity> entities(cell_count * capacity, entt::null);
+
+  for (std::size_t i = 0; i != cell_count; ++i)
+    std::copy_n(m_entities.begin() + i * m_cell_capacity, m_entity_count[i],
+                entities.begin() + i * capacity);
+
+  m_entities.swap(entities);
+  m_cell_capacity = capacity;
 }
@@ -8,9 +8,11 @@
 #include <iscool/meta/underlying_type.hpp>
 #include <iscool/net/endianness.hpp>
 
+#include <entt/core/type_traits.hpp>
 #include <entt/entity/registry.hpp>
 
 #include <type_traits>
+#include <utility>
 
 namespace
 {
@@ -20,6 +22,15 @@ namespace
     std::size_t length;
     std::uint32_t result;
   };
+
+  using component_type_list = entt::type_list<
+#define bim_game_x_component(n) bim::game::n,
+#include <bim/game/for_each_component.hpp>
+      void>;
+
+  template <typename T>
+  constexpr std::size_t component_type_index =
+      entt::type_list_index_v<T, component_type_list>;
 }
 
 static std::uint32_t sum(const char* b, std::size_t n, std::uint32_t v)
@@ -72,6 +83,17 @@ static void update_checksum(checksum_state& checksum_state, entt::entity e)
   push_checksum_bytes(checksum_state, entt::to_entity(e));
 }
 
+static std::uint32_t entity_checksum(entt::entity e)
+{
+  checksum_state checksum;
+  checksum.length = 0;
+  checksum.result = 0;
+
+  update_checksum(checksum, e);
+
+  return sum(&checksum.bytes[0], checksum.length, checksum.result);
+}
+
 static void update_checksum(checksum_state& checksum_state,
                             const bim::game::animation_state& c)
 {
@@ -209,6 +231,23 @@ update_checksum_for_component(checksum_state& checksum_state,
   push_checksum_bytes(checksum_state, n);
 }
 
+template <typename T>
+static void update_checksum_for_component_values(checksum_state& checksum_state,
+                                                 const entt::registry& registry)
+{
+  if constexpr (!std::is_empty_v<T>)
+    {
+      const entt::registry::storage_for_type<T>* const storage =
+          registry.storage<T>();
+
+      if (!storage)
+        return;
+
+      for (const T& c : *storage)
+        update_checksum(checksum_state, c);
+    }
+}
+
 std::uint32_t bim::game::game_state_checksum(const entt::registry& registry)
 {
   ZoneScoped;
@@ -248,3 +287,124 @@ std::uint32_t bim::game::game_state_checksum(const entt::registry& registry)
 
   return checksum.result;
 }
+
+bim::game::incremental_game_state_checksum::incremental_game_state_checksum(
+    entt::registry& registry)
+  : m_registry(registry)
+  , m_entity_checksum(0)
+  , m_entity_count(0)
+{
+  m_component_checksum.fill(0);
+  m_component_count.fill(0);
+
+  for (const entt::entity e : registry.view<entt::entity>())
+    on_entity_construct(registry, e);
+
+  registry.on_construct<entt::entity>()
+      .connect<&incremental_game_state_checksum::on_entity_construct>(*this);
+  registry.on_destroy<entt::entity>()
+      .connect<&incremental_game_state_checksum::on_entity_destroy>(*this);
+
+#define bim_game_x_component(n)                                               \
+  for (const entt::entity e : registry.view<n>())                             \
+    on_component_construct<n>(registry, e);                                   \
+                                                                              \
+  registry.on_construct<n>()                                                  \
+      .connect<&incremental_game_state_checksum::on_component_construct<n>>(  \
+          *this);                                                             \
+  registry.on_destroy<n>()                                                    \
+      .connect<&incremental_game_state_checksum::on_component_destroy<n>>(    \
+          *this);
+#include <bim/game/for_each_component.hpp>
+}
+
+bim::game::incremental_game_state_checksum::~incremental_game_state_checksum()
+{
+  m_registry.on_construct<entt::entity>().disconnect(*this);
+  m_registry.on_destroy<entt::entity>().disconnect(*this);
+
+#define bim_game_x_component(n)                                               \
+  m_registry.on_construct<n>().disconnect(*this);                             \
+  m_registry.on_destroy<n>().disconnect(*this);
+#include <bim/game/for_each_component.hpp>
+}
+
+std::uint32_t bim::game::incremental_game_state_checksum::value() const
+{
+  ZoneScoped;
+
+  const entt::registry& registry = m_registry;
+
+  if (m_entity_count != registry.storage<entt::entity>()->free_list())
+    resync_entities();
+
+  checksum_state checksum;
+  checksum.length = 0;
+  checksum.result = m_entity_checksum;
+
+  push_checksum_bytes(checksum, m_entity_count);
+
+  std::uint8_t type_index = 0;
+
+  // Same bytes than in game_state_checksum(), in a different order.
+#define bim_game_x_component(n)                                               \
+  update_checksum_for_component_values<n>(checksum, registry);                \
+  checksum.result += m_component_checksum[type_index];                        \
+  push_checksum_bytes(checksum, m_component_count[type_index]);               \
+  push_checksum_bytes(checksum, type_index);                                  \
+  ++type_index;
+#include <bim/game/for_each_component.hpp>
+
+  checksum.result = sum(&checksum.bytes[0], checksum.length, checksum.result);
+
+  return checksum.result;
+}
+
+void bim::game::incremental_game_state_checksum::resync_entities() const
+{
+  m_entity_checksum = 0;
+  m_entity_count = 0;
+
+  for (const entt::entity e : std::as_const(m_registry).view<entt::entity>())
+    {
+      m_entity_checksum += entity_checksum(e);
+      ++m_entity_count;
+    }
+}
+
+void bim::game::incremental_game_state_checksum::on_entity_construct(
+    entt::registry&, entt::entity e)
+{
+  m_entity_checksum += entity_checksum(e);
+  ++m_entity_count;
+}
+
+void bim::game::incremental_game_state_checksum::on_entity_destroy(
+    entt::registry&, entt::entity e)
+{
+  assert(m_entity_count > 0);
+
+  m_entity_checksum -= entity_checksum(e);
+  --m_entity_count;
+}
+
+template <typename T>
+void bim::game::incremental_game_state_checksum::on_component_construct(
+    entt::registry&, entt::entity e)
+{
+  constexpr std::size_t i = component_type_index<T>;
+
+  m_component_checksum[i] += entity_checksum(e);
+  ++m_component_count[i];
+}
+
+template <typename T>
+void bim::game::incremental_game_state_checksum::on_component_destroy(
+    entt::registry&, entt::entity e)
+{
+  constexpr std::size_t i = component_type_index<T>;
+  assert(m_component_count[i] > 0);
+
+  m_component_checksum[i] -= entity_checksum(e);
+  --m_component_count[i];
+}
@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/game_state_snapshot.hpp>
+
+#include <bim/game/all_components.hpp>
+
+#include <bim/tracy.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+  template <typename T>
+  struct saved_storage
+  {
+    /// The entities having the component, in the packed order of the storage.
+    std::vector<entt::entity> entities;
+
+    /// The components of the entities, empty for tag components.
+    std::vector<T> values;
+  };
+}
+
+struct bim::game::game_state_snapshot::storages
+{
+#define bim_game_x_component(n) saved_storage<n> n##_storage;
+#include <bim/game/for_each_component.hpp>
+};
+
+static bool same_entities(const entt::entity* entities, std::size_t n,
+                          const entt::entity* saved_entities,
+                          std::size_t saved_n)
+{
+  return (n == saved_n) && std::equal(entities, entities + n, saved_entities);
+}
+
+template <typename T>
+static bool same_value(const T& lhs, const T& rhs)
+{
+  // The components are plain data, as expected by serialize_state(), thus a
+  // byte comparison is enough. Differences in the padding would only cause
+  // an unnecessary copy.
+  return std::memcmp(std::addressof(lhs), std::addressof(rhs), sizeof(T))
+         == 0;
+}
+
+template <typename T>
+static void save_storage(saved_storage<T>& saved,
+                         const entt::registry& registry)
+{
+  const entt::registry::storage_for_type<T>* const storage =
+      registry.storage<T>();
+
+  if (!storage)
+    {
+      saved.entities.clear();
+      saved.values.clear();
+      return;
+    }
+
+  const std::size_t n = storage->size();
+  const entt::entity* const entities = storage->data();
+
+  if (!same_entities(entities, n, saved.entities.data(),
+                     saved.entities.size()))
+    saved.entities.assign(entities, entities + n);
+
+  if constexpr (!std::is_empty_v<T>)
+    {
+      saved.values.resize(n);
+
+      for (std::size_t i = 0; i != n; ++i)
+        {
+          const T& value = storage->get(entities[i]);
+
+          if (!same_value(value, saved.values[i]))
+            saved.values[i] = value;
+        }
+    }
+}
+
+template <typename T>
+static void restore_storage(entt::registry& registry,
+                            const saved_storage<T>& saved)
+{
+  entt::registry::storage_for_type<T>& storage = registry.storage<T>();
+  const std::size_t n = saved.entities.size();
+
+  // The packed order of the storage defines the iteration order in the
+  // systems, thus we must rebuild it exactly. The entities created since the
+  // save are usually at the end of the storage, and a destroyed entity is
+  // replaced by the last one, so we keep the common prefix and recreate the
+  // components after it.
+  const std::size_t common = static_cast<std::size_t>(
+      std::mismatch(saved.entities.begin(), saved.entities.end(),
+                    storage.data(), storage.data() + storage.size())
+          .first
+      - saved.entities.begin());
+
+  if ((common != n) || (storage.size() != n))
+    {
+      // Removing the last component does not move the others.
+      while (storage.size() != common)
+        storage.erase(storage.data()[storage.size() - 1]);
+
+      if constexpr (std::is_empty_v<T>)
+        storage.insert(saved.entities.begin() + common, saved.entities.end());
+      else
+        storage.insert(saved.entities.begin() + common, saved.entities.end(),
+                       saved.values.begin() + common);
+    }
+
+  if constexpr (!std::is_empty_v<T>)
+    for (std::size_t i = 0; i != common; ++i)
+      {
+        T& value = storage.get(saved.entities[i]);
+
+        if (!same_value(value, saved.values[i]))
+          value = saved.values[i];
+      }
+}
+
+bim::game::game_state_snapshot::game_state_snapshot()
+  : m_storages(new storages())
+{}
+
+bim::game::game_state_snapshot::~game_state_snapshot() = default;
+
+void bim::game::game_state_snapshot::save(const entt::registry& registry)
+{
+  ZoneScoped;
+
+  const entt::registry::storage_for_type<entt::entity>& entities =
+      *registry.storage<entt::entity>();
+  const std::size_t n = entities.size();
+
+  m_entities.resize(n + 2);
+  m_entities[0] = static_cast<entt::entity>(n);
+  m_entities[1] = static_cast<entt::entity>(entities.free_list());
+  std::copy_n(entities.data(), n, m_entities.begin() + 2);
+
+#define bim_game_x_component(n)                                               \
+  save_storage(m_storages->n##_storage, registry);
+#include <bim/game/for_each_component.hpp>
+}
+
+void bim::game::game_state_snapshot::restore(entt::registry& registry) const
+{
+  ZoneScoped;
+
+  assert(!m_entities.empty());
+
+  const entt::registry::storage_for_type<entt::entity>& entities =
+      *std::as_const(registry).storage<entt::entity>();
+
+  // The exact sequence of entities, including the free list, defines the
+  // identifiers of the next created entities. If anything differs we rebuild
+  // this sequence, without touching the components. The components of the
+  // entities created or destroyed since the save are restored with the
+  // others below.
+  if ((static_cast<entt::entity>(entities.free_list()) != m_entities[1])
+      || !same_entities(entities.data(), entities.size(),
+                        m_entities.data() + 2, m_entities.size() - 2))
+    {
+      registry.storage<entt::entity>().clear();
+
+      // Creating the entities in an empty storage appends them in order,
+      // then the free list marks those past the entities in use as
+      // released, like entt::snapshot_loader does.
+      for (std::size_t i = 2, n = m_entities.size(); i != n; ++i)
+        registry.create(m_entities[i]);
+
+      registry.storage<entt::entity>().free_list(
+          static_cast<std::size_t>(m_entities[1]));
+
+      assert(same_entities(entities.data(), entities.size(),
+                           m_entities.data() + 2, m_entities.size() - 2));
+    }
+
+#define bim_game_x_component(n)                                               \
+  restore_storage(registry, m_storages->n##_storage);
+#include <bim/game/for_each_component.hpp>
+}
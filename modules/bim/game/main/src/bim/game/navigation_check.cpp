@@ -7,12 +7,41 @@
 #include <bim/game/is_solid.hpp>
 
 #include <bim/table_2d.impl.hpp>
+#include <bim/unreachable.hpp>
 
 #include <algorithm>
+#include <cassert>
+
+// The directions in which we can move from a cell: up, left, right, down.
+static constexpr int g_dx[] = { 0, -1, 1, 0 };
+static constexpr int g_dy[] = { -1, 0, 0, 1 };
+static constexpr bim::game::cell_edge g_edge[] = {
+  bim::game::cell_edge::up, bim::game::cell_edge::left,
+  bim::game::cell_edge::right, bim::game::cell_edge::down
+};
+static constexpr bim::game::cell_edge g_opposite_edge[] = {
+  bim::game::cell_edge::down, bim::game::cell_edge::right,
+  bim::game::cell_edge::left, bim::game::cell_edge::up
+};
+
+bim::game::navigation_check::navigation_check()
+  : navigation_check(algorithm::automatic)
+{}
+
+bim::game::navigation_check::navigation_check(algorithm a)
+  : m_algorithm(a)
+  , m_moves_revision(0)
+  , m_width(0)
+{}
 
-bim::game::navigation_check::navigation_check() = default;
 bim::game::navigation_check::~navigation_check() = default;
 
+bool bim::game::navigation_check::fits_in_bitboard(const arena& arena)
+{
+  return (arena.width() * arena.height() <= cell_bitboard::capacity)
+         && (arena.width() < cell_bitboard::bits_per_word);
+}
+
 enum class bim::game::navigation_check::scan_loop_policy : std::uint8_t
 {
   allow,
@@ -29,6 +58,9 @@ bool bim::game::navigation_check::reachable(const arena& arena,
                                             std::uint8_t to_x,
                                             std::uint8_t to_y)
 {
+  if (use_bitboard(arena))
+    return reachable_bitboard(arena, from_x, from_y, to_x, to_y);
+
   // Distance to the target.
   const auto distance = [=](int x, int y) -> int
     {
@@ -71,6 +103,13 @@ void bim::game::navigation_check::paths(
     std::uint8_t from_x, std::uint8_t from_y,
     const bim::table_2d<bool>& allowed)
 {
+  if (use_bitboard(arena))
+    {
+      paths_bitboard(distance, previous, registry, arena, entity_map, from_x,
+                     from_y, allowed);
+      return;
+    }
+
   distance.fill(unreachable);
   distance(from_x, from_y) = 0;
   previous(from_x, from_y) = position_on_grid(from_x, from_y);
@@ -138,6 +177,10 @@ bool bim::game::navigation_check::exists(const entt::registry& registry,
                                          std::uint8_t from_y, int max_distance,
                                          const bim::table_2d<bool>& forbidden)
 {
+  if (use_bitboard(arena))
+    return exists_bitboard(registry, arena, entity_map, from_x, from_y,
+                           max_distance, forbidden);
+
   const auto distance = [=](int x, int y) -> int
     {
       return std::abs(x - from_x) + std::abs(y - from_y);
@@ -185,17 +228,6 @@ void bim::game::navigation_check::scan(const arena& arena, std::uint8_t from_x,
                                        std::uint8_t from_y, Enter&& enter,
                                        Visit&& visit, Distance&& distance)
 {
-  static constexpr int dx[] = { 0, -1, 1, 0 };
-  static constexpr int dy[] = { -1, 0, 0, 1 };
-  static constexpr bim::game::cell_edge edge[] = {
-    bim::game::cell_edge::up, bim::game::cell_edge::left,
-    bim::game::cell_edge::right, bim::game::cell_edge::down
-  };
-  static constexpr bim::game::cell_edge opposite_edge[] = {
-    bim::game::cell_edge::down, bim::game::cell_edge::right,
-    bim::game::cell_edge::left, bim::game::cell_edge::up
-  };
-
   const int arena_width = arena.width();
   const int arena_height = arena.height();
 
@@ -219,12 +251,12 @@ void bim::game::navigation_check::scan(const arena& arena, std::uint8_t from_x,
         return;
 
       const cell_edge e = arena.fences(p.x, p.y);
-      const bool no_edge[] = { !(e & edge[0]), !(e & edge[1]), !(e & edge[2]),
-                               !(e & edge[3]) };
-      const int neighbor_x[] = { p.x + dx[0], p.x + dx[1], p.x + dx[2],
-                                 p.x + dx[3] };
-      const int neighbor_y[] = { p.y + dy[0], p.y + dy[1], p.y + dy[2],
-                                 p.y + dy[3] };
+      const bool no_edge[] = { !(e & g_edge[0]), !(e & g_edge[1]),
+                               !(e & g_edge[2]), !(e & g_edge[3]) };
+      const int neighbor_x[] = { p.x + g_dx[0], p.x + g_dx[1], p.x + g_dx[2],
+                                 p.x + g_dx[3] };
+      const int neighbor_y[] = { p.y + g_dy[0], p.y + g_dy[1], p.y + g_dy[2],
+                                 p.y + g_dy[3] };
       const bool in_left[] = { neighbor_x[0] >= 0, neighbor_x[1] >= 0,
                                neighbor_x[2] >= 0, neighbor_x[3] >= 0 };
       const bool in_right[] = { neighbor_x[0] < arena_width,
@@ -244,7 +276,7 @@ void bim::game::navigation_check::scan(const arena& arena, std::uint8_t from_x,
         (bool)(no_edge[3] & in_left[3] & in_right[3] & in_up[3] & in_down[3])
       };
 
-      for (std::size_t i = 0; i != std::size(dx); ++i)
+      for (std::size_t i = 0; i != std::size(g_dx); ++i)
         {
           if (!candidate[i])
             continue;
@@ -254,7 +286,7 @@ void bim::game::navigation_check::scan(const arena& arena, std::uint8_t from_x,
 
           if (((ScanLoopPolicy == scan_loop_policy::forbid)
                && m_queued(nx, ny))
-              || !!(arena.fences(nx, ny) & opposite_edge[i])
+              || !!(arena.fences(nx, ny) & g_opposite_edge[i])
               || arena.is_static_wall(nx, ny))
             continue;
 
@@ -279,3 +311,217 @@ void bim::game::navigation_check::scan(const arena& arena, std::uint8_t from_x,
     }
   while (!m_pending.empty());
 }
+
+bool bim::game::navigation_check::use_bitboard(const arena& arena) const
+{
+  if (m_algorithm == algorithm::best_first)
+    return false;
+
+  const bool fits = fits_in_bitboard(arena);
+  assert(fits || (m_algorithm == algorithm::automatic));
+
+  return fits;
+}
+
+void bim::game::navigation_check::build_moves(const arena& arena)
+{
+  if (arena.revision() == m_moves_revision)
+    return;
+
+  m_moves_revision = arena.revision();
+
+  const int arena_width = arena.width();
+  const int arena_height = arena.height();
+
+  m_width = arena_width;
+  m_moves.fill(cell_bitboard());
+
+  for (int y = 0, i = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x, ++i)
+      {
+        const cell_edge e = arena.fences(x, y);
+
+        for (std::size_t d = 0; d != std::size(g_dx); ++d)
+          {
+            const int nx = x + g_dx[d];
+            const int ny = y + g_dy[d];
+
+            if ((nx >= 0) && (nx < arena_width) && (ny >= 0)
+                && (ny < arena_height) && !(e & g_edge[d])
+                && !(arena.fences(nx, ny) & g_opposite_edge[d])
+                && !arena.is_static_wall(nx, ny))
+              m_moves[d].set(i);
+          }
+      }
+}
+
+/// The cells reached by moving the given cells in the given direction.
+bim::game::cell_bitboard
+bim::game::navigation_check::move(const cell_bitboard& cells,
+                                  int direction) const
+{
+  const cell_bitboard movable = cells & m_moves[direction];
+
+  switch (direction)
+    {
+    case 0:
+      return movable >> m_width;
+    case 1:
+      return movable >> 1;
+    case 2:
+      return movable << 1;
+    case 3:
+      return movable << m_width;
+    }
+
+  bim_unreachable;
+}
+
+bool bim::game::navigation_check::reachable_bitboard(const arena& arena,
+                                                     std::uint8_t from_x,
+                                                     std::uint8_t from_y,
+                                                     std::uint8_t to_x,
+                                                     std::uint8_t to_y)
+{
+  build_moves(arena);
+
+  const std::size_t target = to_y * m_width + to_x;
+
+  cell_bitboard visited;
+  visited.set(from_y * m_width + from_x);
+
+  cell_bitboard front = visited;
+
+  while (!visited.test(target))
+    {
+      front = (move(front, 0) | move(front, 1) | move(front, 2)
+               | move(front, 3))
+              - visited;
+
+      if (!front.any())
+        return false;
+
+      visited |= front;
+    }
+
+  return true;
+}
+
+void bim::game::navigation_check::paths_bitboard(
+    bim::table_2d<std::uint8_t>& distance,
+    bim::table_2d<position_on_grid>& previous, const entt::registry& registry,
+    const arena& arena, const entity_world_map& entity_map,
+    std::uint8_t from_x, std::uint8_t from_y,
+    const bim::table_2d<bool>& allowed)
+{
+  build_moves(arena);
+
+  const int arena_width = arena.width();
+  const int arena_height = arena.height();
+
+  cell_bitboard walkable;
+
+  for (int y = 0, i = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x, ++i)
+      if (!arena.is_static_wall(x, y) && allowed(x, y)
+          && !is_solid(registry, entity_map, x, y))
+        walkable.set(i);
+
+  distance.fill(unreachable);
+  distance(from_x, from_y) = 0;
+  previous(from_x, from_y) = position_on_grid(from_x, from_y);
+
+  cell_bitboard visited;
+  visited.set(from_y * m_width + from_x);
+
+  cell_bitboard front = visited;
+
+  // The cells next to a visited cell, that we could enter if there was not
+  // something solid or forbidden on them.
+  cell_bitboard border_cells;
+
+  for (int d = 1; front.any(); ++d)
+    {
+      cell_bitboard next_front;
+
+      for (std::size_t direction = 0; direction != std::size(g_dx);
+           ++direction)
+        {
+          const cell_bitboard reached = move(front, direction);
+          border_cells |= reached - walkable;
+
+          const cell_bitboard entered =
+              (reached & walkable) - visited - next_front;
+
+          entered.for_each(
+              [&](std::size_t i) -> void
+                {
+                  const int x = i % m_width;
+                  const int y = i / m_width;
+
+                  distance(x, y) = d;
+                  previous(x, y) = position_on_grid(x - g_dx[direction],
+                                                    y - g_dy[direction]);
+                });
+
+          next_front |= entered;
+        }
+
+      visited |= next_front;
+      front = next_front;
+    }
+
+  border_cells.for_each(
+      [&](std::size_t i) -> void
+        {
+          distance(i % m_width, i / m_width) = border;
+        });
+}
+
+bool bim::game::navigation_check::exists_bitboard(
+    const entt::registry& registry, const arena& arena,
+    const entity_world_map& entity_map, std::uint8_t from_x,
+    std::uint8_t from_y, int max_distance,
+    const bim::table_2d<bool>& forbidden)
+{
+  build_moves(arena);
+
+  const int arena_width = arena.width();
+  const int arena_height = arena.height();
+
+  // The cells where we can pass, and those where we want to go.
+  cell_bitboard walkable;
+  cell_bitboard goals;
+
+  for (int y = 0, i = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x, ++i)
+      {
+        if (!forbidden(x, y))
+          goals.set(i);
+
+        if ((std::abs(x - from_x) + std::abs(y - from_y) <= max_distance)
+            && !arena.is_static_wall(x, y)
+            && !is_solid(registry, entity_map, x, y))
+          walkable.set(i);
+      }
+
+  cell_bitboard visited;
+  visited.set(from_y * m_width + from_x);
+
+  cell_bitboard front = visited;
+
+  while (!(visited & goals).any())
+    {
+      front = ((move(front, 0) | move(front, 1) | move(front, 2)
+                | move(front, 3))
+               & walkable)
+              - visited;
+
+      if (!front.any())
+        return false;
+
+      visited |= front;
+    }
+
+  return true;
+}
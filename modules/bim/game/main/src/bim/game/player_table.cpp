@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/player_table.hpp>
+
+#include <bim/game/component/fractional_position_on_grid.hpp>
+#include <bim/game/component/player.hpp>
+#include <bim/game/component/player_action.hpp>
+#include <bim/game/component/player_action_queue.hpp>
+
+#include <bim/assume.hpp>
+
+#include <entt/entity/registry.hpp>
+
+bim::game::player_table::player_table(entt::registry& registry)
+  : m_registry(registry)
+  , m_size(0)
+  , m_dirty(true)
+{
+  // Removing a component moves the last one of its storage in its place,
+  // thus the addresses kept in the table may change on any destruction, in
+  // addition to the new players on a construction.
+  registry.on_construct<player>().connect<&player_table::invalidate>(*this);
+  registry.on_destroy<player>().connect<&player_table::invalidate>(*this);
+  registry.on_construct<fractional_position_on_grid>()
+      .connect<&player_table::invalidate>(*this);
+  registry.on_destroy<fractional_position_on_grid>()
+      .connect<&player_table::invalidate>(*this);
+  registry.on_construct<player_action>()
+      .connect<&player_table::invalidate>(*this);
+  registry.on_destroy<player_action>()
+      .connect<&player_table::invalidate>(*this);
+  registry.on_construct<player_action_queue>()
+      .connect<&player_table::invalidate>(*this);
+  registry.on_destroy<player_action_queue>()
+      .connect<&player_table::invalidate>(*this);
+}
+
+bim::game::player_table::~player_table()
+{
+  m_registry.on_construct<player>().disconnect(*this);
+  m_registry.on_destroy<player>().disconnect(*this);
+  m_registry.on_construct<fractional_position_on_grid>().disconnect(*this);
+  m_registry.on_destroy<fractional_position_on_grid>().disconnect(*this);
+  m_registry.on_construct<player_action>().disconnect(*this);
+  m_registry.on_destroy<player_action>().disconnect(*this);
+  m_registry.on_construct<player_action_queue>().disconnect(*this);
+  m_registry.on_destroy<player_action_queue>().disconnect(*this);
+}
+
+void bim::game::player_table::refresh()
+{
+  if (!m_dirty)
+    return;
+
+  m_size = 0;
+
+  // The players are processed in the order of the view, as the bombs dropped
+  // by a player may block the next ones.
+  for (const auto& [entity, player, position, action, action_queue] :
+       m_registry
+           .view<player, fractional_position_on_grid, player_action,
+                 player_action_queue>()
+           .each())
+    {
+      bim_assume(m_size < entities.size());
+
+      entities[m_size] = entity;
+      players[m_size] = &player;
+      positions[m_size] = &position;
+      actions[m_size] = &action;
+      action_queues[m_size] = &action_queue;
+      ++m_size;
+    }
+
+  m_dirty = false;
+}
+
+std::uint8_t bim::game::player_table::size() const
+{
+  return m_size;
+}
+
+void bim::game::player_table::invalidate(entt::registry&, entt::entity)
+{
+  m_dirty = true;
+}
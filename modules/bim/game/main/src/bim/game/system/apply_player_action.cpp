@@ -11,6 +11,7 @@
 #include <bim/game/entity_world_map.hpp>
 #include <bim/game/factory/bomb.hpp>
 #include <bim/game/is_solid.hpp>
+#include <bim/game/player_table.hpp>
 #include <bim/game/system/move_player.hpp>
 
 #include <entt/entity/registry.hpp>
@@ -122,31 +123,46 @@ void bim::game::apply_player_action(const context& context,
                                     entt::registry& registry,
                                     const arena& arena,
                                     bim::game::entity_world_map& entity_map)
+{
+  player_table players(registry);
+  apply_player_action(context, players, registry, arena, entity_map);
+}
+
+void bim::game::apply_player_action(const context& context,
+                                    player_table& players,
+                                    entt::registry& registry,
+                                    const arena& arena,
+                                    bim::game::entity_world_map& entity_map)
 {
   const player_animations& animations = context.get<const player_animations>();
+  entt::registry::storage_for_type<animation_state>& states =
+      registry.storage<animation_state>();
+
+  players.refresh();
 
-  registry
-      .view<player, fractional_position_on_grid, player_action,
-            player_action_queue, animation_state>()
-      .each(
-          [&](entt::entity e, player& player,
-              fractional_position_on_grid& position,
-              player_action& scheduled_action,
-              player_action_queue& action_queue,
-              animation_state& state) -> void
-            {
-              if (!animations.is_alive(state.model))
-                {
-                  scheduled_action = {};
-                  return;
-                }
-
-              const queued_action action = action_queue.enqueue(
-                  scheduled_action, position.grid_aligned_x(),
-                  position.grid_aligned_y());
-
-              scheduled_action = {};
-              apply_player_actions(registry, arena, entity_map, animations, e,
-                                   player, position, action, state);
-            });
+  for (std::size_t i = 0, n = players.size(); i != n; ++i)
+    {
+      const entt::entity e = players.entities[i];
+
+      if (!states.contains(e))
+        continue;
+
+      animation_state& state = states.get(e);
+      player_action& scheduled_action = *players.actions[i];
+
+      if (!animations.is_alive(state.model))
+        {
+          scheduled_action = {};
+          continue;
+        }
+
+      fractional_position_on_grid& position = *players.positions[i];
+      const queued_action action = players.action_queues[i]->enqueue(
+          scheduled_action, position.grid_aligned_x(),
+          position.grid_aligned_y());
+
+      scheduled_action = {};
+      apply_player_actions(registry, arena, entity_map, animations, e,
+                           *players.players[i], position, action, state);
+    }
 }
@@ -15,6 +15,8 @@
 
 #include <entt/entity/registry.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 
 template class bim::table_2d<bim::game::fog_of_war*>;
@@ -25,6 +27,34 @@ static constexpr std::chrono::milliseconds g_fog_hide_duration(100);
 
 namespace bim::game::detail
 {
+  static constexpr std::size_t g_bits_per_word = 64;
+
+  static std::size_t bit_word_count(std::size_t bit_count)
+  {
+    return (bit_count + g_bits_per_word - 1) / g_bits_per_word;
+  }
+
+  static void set_bit(std::vector<std::uint64_t>& bits, std::size_t i)
+  {
+    bits[i / g_bits_per_word] |= std::uint64_t(1) << (i % g_bits_per_word);
+  }
+
+  static bool test_bit(const std::vector<std::uint64_t>& bits, std::size_t i)
+  {
+    return bits[i / g_bits_per_word]
+           & (std::uint64_t(1) << (i % g_bits_per_word));
+  }
+
+  static void clear_bits(std::vector<std::uint64_t>& bits)
+  {
+    std::fill(bits.begin(), bits.end(), 0);
+  }
+
+  static void mark_active(fog_properties& p, int x, int y)
+  {
+    set_bit(p.active, y * p.fog.width() + x);
+  }
+
   static void add_neighbor(const fog_properties& p, int x, int y,
                            cell_neighborhood n)
   {
@@ -69,7 +99,7 @@ namespace bim::game::detail
     remove_neighbor(p, x + 1, y + 1, cell_neighborhood::up_left);
   }
 
-  static void hide(const fog_properties& p, int x, int y)
+  static void hide(fog_properties& p, int x, int y)
   {
     if ((x < 0) || ((std::size_t)x >= p.fog.width()) || (y < 0)
         || ((std::size_t)y >= p.fog.height()))
@@ -81,6 +111,7 @@ namespace bim::game::detail
       return;
 
     f->state = fog_state::hiding;
+    mark_active(p, x, y);
 
     assert(p.timer(x, y) != nullptr);
     p.timer(x, y)->duration =
@@ -89,7 +120,7 @@ namespace bim::game::detail
     uncover(p, x, y);
   }
 
-  static void blow(const fog_properties& p, int x, int y)
+  static void blow(fog_properties& p, int x, int y)
   {
     fog_of_war* const f = p.fog(x, y);
 
@@ -98,6 +129,7 @@ namespace bim::game::detail
       return;
 
     f->state = fog_state::blown;
+    mark_active(p, x, y);
 
     timer* const t = p.timer(x, y);
     assert(t != nullptr);
@@ -106,7 +138,7 @@ namespace bim::game::detail
     uncover(p, x, y);
   }
 
-  static void uncover_around_player(const fog_properties& p, int player_x,
+  static void uncover_around_player(fog_properties& p, int player_x,
                                     int player_y)
   {
     hide(p, player_x - 1, player_y - 1);
@@ -125,7 +157,7 @@ namespace bim::game::detail
 
 bim::game::fog_of_war_updater::fog_of_war_updater(const arena& arena,
                                                   std::uint8_t player_count)
-  : m_blown(arena.width(), arena.height())
+  : m_blown(detail::bit_word_count(arena.width() * arena.height()))
   , m_player_count(player_count)
 {
   for (int i = 0; i != player_count; ++i)
@@ -134,6 +166,7 @@ bim::game::fog_of_war_updater::fog_of_war_updater(const arena& arena,
           bim::table_2d<fog_of_war*>(arena.width(), arena.height(), nullptr);
       m_tables[i].timer =
           bim::table_2d<timer*>(arena.width(), arena.height(), nullptr);
+      m_tables[i].active.resize(m_blown.size());
     }
 }
 
@@ -160,9 +193,9 @@ void bim::game::fog_of_war_updater::update_fog(entt::registry& registry,
                                                std::size_t player_index,
                                                int player_x, int player_y)
 {
-  m_blown.fill(false);
+  detail::clear_bits(m_blown);
 
-  const detail::fog_properties& p = m_tables[player_index];
+  detail::fog_properties& p = m_tables[player_index];
   detail::uncover_around_player(p, player_x, player_y);
 
   if (m_player_count <= 2)
@@ -177,23 +210,39 @@ void bim::game::fog_of_war_updater::build_maps(entt::registry& registry)
     {
       p.fog.fill(nullptr);
       p.timer.fill(nullptr);
+      detail::clear_bits(p.active);
     }
 
   registry.view<fog_of_war, timer, position_on_grid>().each(
       [&](fog_of_war& fog, timer& t, const position_on_grid& position) -> void
         {
-          m_tables[fog.player_index].fog(position.x, position.y) = &fog;
-          m_tables[fog.player_index].timer(position.x, position.y) = &t;
+          detail::fog_properties& p = m_tables[fog.player_index];
+
+          p.fog(position.x, position.y) = &fog;
+          p.timer(position.x, position.y) = &t;
+
+          // The stable fogs and the completely hidden fogs won't change
+          // unless something happens in update_fog(), which will then mark
+          // them as active.
+          const bool idle =
+              (fog.state == fog_state::stable)
+              || ((fog.state == fog_state::hiding) && (fog.opacity == 0)
+                  && (t.duration.count() == 0));
+
+          if (!idle)
+            detail::mark_active(p, position.x, position.y);
         });
 }
 
 void bim::game::fog_of_war_updater::uncover_around_flames(
-    entt::registry& registry, const detail::fog_properties& p)
+    entt::registry& registry, detail::fog_properties& p)
 {
+  const std::size_t width = p.fog.width();
+
   registry.view<flame, position_on_grid>().each(
       [&](const flame&, const position_on_grid& position) -> void
         {
-          m_blown(position.x, position.y) = true;
+          detail::set_bit(m_blown, position.y * width + position.x);
           detail::blow(p, position.x, position.y);
         });
 }
@@ -202,15 +251,21 @@ void bim::game::fog_of_war_updater::update_opacity_from_timers(
     const detail::fog_properties& p) const
 {
   const std::size_t w = p.fog.width();
-  const std::size_t h = p.fog.height();
 
-  for (std::size_t y = 0; y != h; ++y)
-    for (std::size_t x = 0; x != w; ++x)
+  // Only the cells whose fog is changing are visited, in increasing order of
+  // index, as in a scan of the rows.
+  for (std::size_t word_index = 0; word_index != p.active.size();
+       ++word_index)
+    for (std::uint64_t bits = p.active[word_index]; bits != 0;
+         bits &= bits - 1)
       {
-        fog_of_war* const f = p.fog(x, y);
+        const std::size_t i = word_index * detail::g_bits_per_word
+                              + std::countr_zero(bits);
+        const int x = i % w;
+        const int y = i / w;
 
-        if (!f)
-          continue;
+        fog_of_war* const f = p.fog(x, y);
+        assert(f != nullptr);
 
         assert(p.timer(x, y) != nullptr);
         timer* const t = p.timer(x, y);
@@ -228,7 +283,7 @@ void bim::game::fog_of_war_updater::update_opacity_from_timers(
 
               // Do not restore the flame if it has been blown in the current
               // iteration.
-              if (!m_blown(x, y) && (t->duration.count() == 0))
+              if (!detail::test_bit(m_blown, i) && (t->duration.count() == 0))
                 {
                   f->state = fog_state::restore;
                   t->duration = g_fog_restore_duration;
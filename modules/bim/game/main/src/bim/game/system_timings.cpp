@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/system_timings.hpp>
+
+#include <bim/unreachable.hpp>
+
+std::string_view bim::game::system_name(system_id id)
+{
+  switch (id)
+    {
+#define bim_game_x_system(n)                                                  \
+  case system_id::n:                                                          \
+    return #n;
+#include <bim/game/for_each_system.hpp>
+    case system_id::count:
+      break;
+    }
+
+  bim_unreachable;
+}
+
+bim::game::system_timings::system_timings()
+{
+  duration.fill({});
+  calls.fill(0);
+}
+
+bim::game::system_timings&
+bim::game::system_timings::operator+=(const system_timings& that)
+{
+  for (std::size_t i = 0; i != system_count; ++i)
+    {
+      duration[i] += that.duration[i];
+      calls[i] += that.calls[i];
+    }
+
+  return *this;
+}
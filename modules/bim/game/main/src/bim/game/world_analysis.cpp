@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/world_analysis.hpp>
+
+#include <bim/game/arena.hpp>
+#include <bim/game/arena_fall_order.hpp>
+#include <bim/game/component/arena_reduction_state.hpp>
+#include <bim/game/component/bomb.hpp>
+#include <bim/game/component/bomb_power_up.hpp>
+#include <bim/game/component/crate.hpp>
+#include <bim/game/component/falling_block.hpp>
+#include <bim/game/component/flame.hpp>
+#include <bim/game/component/flame_power_up.hpp>
+#include <bim/game/component/invisibility_power_up.hpp>
+#include <bim/game/component/power_up.hpp>
+#include <bim/game/component/shield_power_up.hpp>
+#include <bim/game/component/solid.hpp>
+#include <bim/game/component/timer.hpp>
+#include <bim/game/constant/bomb_near_explosion_duration.hpp>
+#include <bim/game/constant/falling_block_duration.hpp>
+#include <bim/game/contest.hpp>
+
+#include <bim/table_2d.impl.hpp>
+#include <bim/tracy.hpp>
+
+#include <entt/core/type_info.hpp>
+#include <entt/entity/registry.hpp>
+
+#include <algorithm>
+
+/// How far in the future we look for the blocks about to fall.
+static constexpr std::chrono::milliseconds g_upcoming_fall_horizon(1200);
+
+static const entt::id_type g_type_void = entt::type_index<void>::value();
+static const entt::id_type g_type_bomb_power_up =
+    entt::type_index<bim::game::bomb_power_up>::value();
+static const entt::id_type g_type_flame_power_up =
+    entt::type_index<bim::game::flame_power_up>::value();
+static const entt::id_type g_type_shield_power_up =
+    entt::type_index<bim::game::shield_power_up>::value();
+static const entt::id_type g_type_invisibility_power_up =
+    entt::type_index<bim::game::invisibility_power_up>::value();
+
+bim::game::world_analysis::world_analysis(std::uint8_t arena_width,
+                                          std::uint8_t arena_height)
+  : m_crate_map(arena_width, arena_height)
+  , m_solid_map(arena_width, arena_height)
+  , m_power_up_map(arena_width, arena_height)
+{}
+
+bim::game::world_analysis::~world_analysis() = default;
+
+void bim::game::world_analysis::update(const contest& contest)
+{
+  ZoneScoped;
+
+  build_crates(contest);
+  build_solid_map(contest);
+  build_dangers(contest);
+  build_power_up_map(contest);
+}
+
+std::span<const bim::game::position_on_grid>
+bim::game::world_analysis::crates() const
+{
+  return m_crates;
+}
+
+const bim::table_2d<bool>& bim::game::world_analysis::crate_map() const
+{
+  return m_crate_map;
+}
+
+const bim::table_2d<bool>& bim::game::world_analysis::solid_map() const
+{
+  return m_solid_map;
+}
+
+std::span<const bim::game::position_on_grid>
+bim::game::world_analysis::flames() const
+{
+  return m_flames;
+}
+
+std::span<const bim::game::position_on_grid>
+bim::game::world_analysis::falling_blocks() const
+{
+  return m_falling_blocks;
+}
+
+std::span<const bim::game::position_on_grid>
+bim::game::world_analysis::upcoming_falls() const
+{
+  return m_upcoming_falls;
+}
+
+const bim::table_2d<entt::id_type>&
+bim::game::world_analysis::power_up_map() const
+{
+  return m_power_up_map;
+}
+
+std::span<const bim::game::world_analysis::bomb_info>
+bim::game::world_analysis::bombs() const
+{
+  return m_bombs;
+}
+
+std::span<const bim::game::position_on_grid>
+bim::game::world_analysis::blast_cells(const bomb_info& b) const
+{
+  return std::span<const position_on_grid>(
+      m_blast_cells.begin() + b.blast_begin,
+      m_blast_cells.begin() + b.blast_end);
+}
+
+void bim::game::world_analysis::build_crates(const contest& contest)
+{
+  m_crates.clear();
+  m_crate_map.fill(false);
+
+  contest.registry().view<crate, position_on_grid>().each(
+      [this](const position_on_grid& p)
+        {
+          m_crates.push_back(p);
+          m_crate_map(p.x, p.y) = true;
+        });
+}
+
+void bim::game::world_analysis::build_solid_map(const contest& contest)
+{
+  m_solid_map.fill(false);
+
+  contest.registry().view<solid, position_on_grid>().each(
+      [this](const position_on_grid& p)
+        {
+          m_solid_map(p.x, p.y) = true;
+        });
+}
+
+void bim::game::world_analysis::build_dangers(const contest& contest)
+{
+  const entt::registry& registry = contest.registry();
+
+  m_flames.clear();
+  registry.view<flame, position_on_grid>().each(
+      [this](const flame&, const position_on_grid& p)
+        {
+          m_flames.push_back(p);
+        });
+
+  m_falling_blocks.clear();
+  registry.view<falling_block, position_on_grid>().each(
+      [this](const position_on_grid& p)
+        {
+          m_falling_blocks.push_back(p);
+        });
+
+  // The next falls are read from the fall order, at the index of the next
+  // fall, no need to compute where the blocks are going to land.
+  m_upcoming_falls.clear();
+
+  const std::span<const position_on_grid> fall_order =
+      contest.fall_order().positions();
+
+  registry.view<arena_reduction_state, timer>().each(
+      [&](const arena_reduction_state& state, const timer& t)
+        {
+          if (t.duration > g_upcoming_fall_horizon)
+            return;
+
+          const std::size_t count =
+              1 + (g_upcoming_fall_horizon - t.duration)
+                      / g_falling_block_duration;
+          const std::size_t end = std::min(
+              fall_order.size(), state.index_of_next_fall + count);
+
+          for (std::size_t i = state.index_of_next_fall; i < end; ++i)
+            m_upcoming_falls.push_back(fall_order[i]);
+        });
+
+  m_bombs.clear();
+  m_blast_cells.clear();
+
+  const arena& arena = contest.arena();
+  const int width = arena.width();
+  const int height = arena.height();
+
+  registry.view<bomb, position_on_grid, timer>().each(
+      [&](const bomb& b, const position_on_grid& p, const timer& t)
+        {
+          bomb_info& info = m_bombs.emplace_back();
+          info.position = p;
+          info.strength = b.strength;
+          info.near_explosion = t.duration <= g_bomb_near_explosion_duration;
+          info.blast_begin = m_blast_cells.size();
+
+          m_blast_cells.push_back(p);
+
+          // Same propagation than in the bots: the blast stops on static
+          // walls, and on the first solid it reaches.
+          const auto propagate = [&](int dx, int dy) -> void
+            {
+              for (int i = 1, x = p.x + dx, y = p.y + dy;
+                   (i <= b.strength) && (x >= 0) && (x < width) && (y >= 0)
+                   && (y < height) && !arena.is_static_wall(x, y);
+                   ++i, x += dx, y += dy)
+                {
+                  m_blast_cells.emplace_back(x, y);
+
+                  if (m_solid_map(x, y))
+                    break;
+                }
+            };
+
+          propagate(-1, 0);
+          propagate(1, 0);
+          propagate(0, -1);
+          propagate(0, 1);
+
+          info.blast_end = m_blast_cells.size();
+        });
+}
+
+void bim::game::world_analysis::build_power_up_map(const contest& contest)
+{
+  m_power_up_map.fill(g_type_void);
+
+  const entt::registry& registry = contest.registry();
+
+  const entt::registry::storage_for_type<bomb_power_up>* const bomb_power_ups =
+      registry.storage<bomb_power_up>();
+  const entt::registry::storage_for_type<flame_power_up>* const
+      flame_power_ups = registry.storage<flame_power_up>();
+  const entt::registry::storage_for_type<shield_power_up>* const
+      shield_power_ups = registry.storage<shield_power_up>();
+  const entt::registry::storage_for_type<invisibility_power_up>* const
+      invisibility_power_ups = registry.storage<invisibility_power_up>();
+
+  const auto contains = [&](const auto* storage, entt::entity e) -> bool
+    {
+      return storage && storage->contains(e);
+    };
+
+  registry.view<power_up, position_on_grid>().each(
+      [&](entt::entity e, const position_on_grid& p)
+        {
+          if (contains(bomb_power_ups, e))
+            m_power_up_map(p.x, p.y) = g_type_bomb_power_up;
+          else if (contains(flame_power_ups, e))
+            m_power_up_map(p.x, p.y) = g_type_flame_power_up;
+          else if (contains(shield_power_ups, e))
+            m_power_up_map(p.x, p.y) = g_type_shield_power_up;
+          else if (contains(invisibility_power_ups, e))
+            m_power_up_map(p.x, p.y) = g_type_invisibility_power_up;
+        });
+}
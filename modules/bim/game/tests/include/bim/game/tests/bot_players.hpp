@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#pragma once
+
+#include <bim/game/bot.hpp>
+#include <bim/game/world_analysis.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace bim::game
+{
+  class contest;
+  class contest_result;
+}
+
+namespace bim::game::tests
+{
+  /**
+   * Bots playing all the players of a contest, sharing a single analysis of
+   * the contest per tick. The players are played by the bots as long as they
+   * are in the game.
+   */
+  class bot_players
+  {
+  public:
+    /**
+     * \param seed The seed of the bot of the first player. The bot of the
+     *        player i uses seed + i.
+     */
+    bot_players(const contest& contest, std::uint8_t player_count,
+                std::uint64_t seed);
+    ~bot_players();
+
+    /// Set the action of each player from its bot, for the next tick.
+    void think(contest& contest);
+
+    /// Call think() then contest.tick().
+    contest_result tick(contest& contest);
+
+    /**
+     * Call tick() tick_count times, or until the game is over. Returns true
+     * if the game is still running.
+     */
+    bool run(contest& contest, int tick_count);
+
+  private:
+    std::vector<bot> m_bots;
+    world_analysis m_world;
+  };
+}
@@ -0,0 +1,50 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/arena_fall_order.hpp>
+
+#include <bim/game/arena.hpp>
+#include <bim/game/level_generation.hpp>
+
+#include <bim/table_2d.impl.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(bim_game_arena_fall_order, all_free_cells)
+{
+  bim::game::arena arena(13, 15);
+  bim::game::generate_basic_level_structure(arena);
+
+  const bim::game::arena_fall_order order(arena);
+  bim::table_2d<int> fall_count(arena.width(), arena.height(), 0);
+
+  for (const bim::game::position_on_grid& p : order.positions())
+    {
+      EXPECT_FALSE(arena.is_static_wall(p.x, p.y))
+          << "x=" << (int)p.x << ", y=" << (int)p.y;
+      ++fall_count(p.x, p.y);
+    }
+
+  for (int y = 0; y != arena.height(); ++y)
+    for (int x = 0; x != arena.width(); ++x)
+      EXPECT_EQ(arena.is_static_wall(x, y) ? 0 : 1, fall_count(x, y))
+          << "x=" << x << ", y=" << y;
+}
+
+TEST(bim_game_arena_fall_order, basic_arena)
+{
+  const bim::game::arena_fall_order& order =
+      bim::game::basic_arena_fall_order(13, 15);
+
+  // The order is computed once for each size.
+  EXPECT_EQ(&order, &bim::game::basic_arena_fall_order(13, 15));
+  EXPECT_NE(&order, &bim::game::basic_arena_fall_order(15, 13));
+
+  bim::game::arena arena(13, 15);
+  bim::game::generate_basic_level_structure(arena);
+
+  const bim::game::arena_fall_order expected(arena);
+
+  ASSERT_EQ(expected.positions().size(), order.positions().size());
+
+  for (std::size_t i = 0; i != order.positions().size(); ++i)
+    EXPECT_EQ(expected.positions()[i], order.positions()[i]) << "i=" << i;
+}
@@ -2,6 +2,7 @@
 #include <bim/game/bot.hpp>
 
 #include <bim/game/component/player_action.hpp>
+#include <bim/game/component/player_movement.hpp>
 #include <bim/game/constant/default_arena_size.hpp>
 #include <bim/game/constant/default_crate_probability.hpp>
 #include <bim/game/constant/max_player_count.hpp>
@@ -11,6 +12,7 @@
 #include <bim/game/feature_flags.hpp>
 #include <bim/game/feature_flags_string.hpp>
 #include <bim/game/player_action.hpp>
+#include <bim/game/world_analysis.hpp>
 
 #include <charconv>
 #include <cstdio>
@@ -66,6 +68,50 @@ void bim_game_bot_test::TearDown()
     printf("Seed is %lu.\n", m_seed);
 }
 
+/**
+ * Play a contest with bots only and tell if it is over before the maximum
+ * game duration.
+ */
+static bool bots_complete_contest(
+    const bim::game::contest_fingerprint& fingerprint,
+    std::uint16_t think_budget)
+{
+  bim::game::contest contest(fingerprint);
+  std::vector<bim::game::bot> bots;
+  bots.reserve(fingerprint.player_count);
+
+  for (int i = 0; i != fingerprint.player_count; ++i)
+    {
+      bots.emplace_back(i, fingerprint.arena_width, fingerprint.arena_height,
+                        fingerprint.seed);
+      bots.back().think_budget(think_budget);
+    }
+
+  bim::game::contest_result result =
+      bim::game::contest_result::create_still_running();
+
+  // We add a small delay to the max duration to let the final animations
+  // finish.
+  const std::size_t max_iterations =
+      (bim::game::contest::max_game_duration + std::chrono::seconds(1))
+      / bim::game::contest::tick_interval;
+
+  std::vector<bim::game::player_action*> actions(fingerprint.player_count);
+
+  for (std::size_t i = 0; (i != max_iterations) && result.still_running(); ++i)
+    {
+      bim::game::collect_player_actions(actions, contest.registry());
+
+      for (int p = 0; p != fingerprint.player_count; ++p)
+        if (actions[p])
+          *actions[p] = bots[p].think(contest);
+
+      result = contest.tick();
+    }
+
+  return !result.still_running();
+}
+
 TEST_P(bim_game_bot_test, think)
 {
   const std::uint8_t player_count = std::get<0>(GetParam());
@@ -80,19 +126,96 @@ TEST_P(bim_game_bot_test, think)
     .arena_height = bim::game::g_default_arena_height
   };
 
+  EXPECT_TRUE(bots_complete_contest(fingerprint, 0));
+}
+
+TEST_P(bim_game_bot_test, think_with_budget)
+{
+  const std::uint8_t player_count = std::get<0>(GetParam());
+  const bim::game::feature_flags feature_flags = std::get<1>(GetParam());
+
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = m_seed,
+    .features = feature_flags,
+    .player_count = player_count,
+    .crate_probability = bim::game::g_default_crate_probability,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  // The bots need several ticks to find a goal but they must still be able
+  // to play.
+  EXPECT_TRUE(bots_complete_contest(fingerprint, 8));
+
+  bim::game::contest contest(fingerprint);
+
+  // Let the bots start.
+  const std::size_t start_tick_count =
+      std::chrono::seconds(1) / bim::game::contest::tick_interval;
+
+  for (std::size_t i = 0; i != start_tick_count; ++i)
+    contest.tick();
+
+  bim::game::bot bot(0, fingerprint.arena_width, fingerprint.arena_height,
+                     fingerprint.seed);
+  bim::game::bot budgeted_bot(0, fingerprint.arena_width,
+                              fingerprint.arena_height, fingerprint.seed);
+  budgeted_bot.think_budget(1);
+
+  // With a single cell per call the search takes many calls on the same
+  // state, during which the bot must go toward the best goal found so far
+  // instead of waiting.
+  const int search_call_count =
+      fingerprint.arena_width * fingerprint.arena_height;
+  bool moved = false;
+
+  for (int i = 0; i != search_call_count; ++i)
+    moved |= budgeted_bot.think(contest).movement
+             != bim::game::player_movement::idle;
+
+  EXPECT_TRUE(moved);
+
+  // Once the search is complete the bot must have picked the same goal than
+  // without a budget.
+  EXPECT_EQ(bot.think(contest), budgeted_bot.think(contest));
+}
+
+TEST_P(bim_game_bot_test, shared_world_analysis)
+{
+  const std::uint8_t player_count = std::get<0>(GetParam());
+  const bim::game::feature_flags feature_flags = std::get<1>(GetParam());
+
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = m_seed,
+    .features = feature_flags,
+    .player_count = player_count,
+    .crate_probability = bim::game::g_default_crate_probability,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  // The bots using the shared analysis must take the same decisions than the
+  // bots doing their own analysis.
   bim::game::contest contest(fingerprint);
   std::vector<bim::game::bot> bots;
+  std::vector<bim::game::bot> shared_bots;
   bots.reserve(player_count);
+  shared_bots.reserve(player_count);
 
   for (int i = 0; i != player_count; ++i)
-    bots.emplace_back(i, fingerprint.arena_width, fingerprint.arena_height,
-                      fingerprint.seed);
+    {
+      bots.emplace_back(i, fingerprint.arena_width, fingerprint.arena_height,
+                        fingerprint.seed);
+      shared_bots.emplace_back(i, fingerprint.arena_width,
+                               fingerprint.arena_height, fingerprint.seed);
+    }
+
+  bim::game::world_analysis world(fingerprint.arena_width,
+                                  fingerprint.arena_height);
 
   bim::game::contest_result result =
       bim::game::contest_result::create_still_running();
 
-  // We add a small delay to the max duration to let the final animations
-  // finish.
   const std::size_t max_iterations =
       (bim::game::contest::max_game_duration + std::chrono::seconds(1))
       / bim::game::contest::tick_interval;
@@ -102,15 +225,21 @@ TEST_P(bim_game_bot_test, think)
   for (std::size_t i = 0; (i != max_iterations) && result.still_running(); ++i)
     {
       bim::game::collect_player_actions(actions, contest.registry());
+      world.update(contest);
 
       for (int p = 0; p != player_count; ++p)
         if (actions[p])
-          *actions[p] = bots[p].think(contest);
+          {
+            const bim::game::player_action action = bots[p].think(contest);
+
+            ASSERT_EQ(action, shared_bots[p].think(contest, world))
+                << "tick=" << i << ", player=" << p;
+
+            *actions[p] = action;
+          }
 
       result = contest.tick();
     }
-
-  EXPECT_TRUE(!result.still_running());
 }
 
 INSTANTIATE_TEST_SUITE_P(
@@ -1,6 +1,9 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #include <bim/game/contest.hpp>
 
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/archive_storage.hpp>
 #include <bim/game/arena.hpp>
 #include <bim/game/component/bomb_power_up_spawner.hpp>
 #include <bim/game/component/flame_power_up_spawner.hpp>
@@ -11,8 +14,13 @@
 #include <bim/game/component/shield_power_up_spawner.hpp>
 #include <bim/game/constant/default_arena_size.hpp>
 #include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/contest_pool.hpp>
+#include <bim/game/context/shared_context.hpp>
+#include <bim/game/entity_world_map.hpp>
 #include <bim/game/feature_flags.hpp>
+#include <bim/game/game_state_serialization.hpp>
 #include <bim/game/level_generation.hpp>
+#include <bim/game/system_timings.hpp>
 
 #include <bim/table_2d.impl.hpp>
 
@@ -20,6 +28,7 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <memory>
 #include <numeric>
 
 #include <gtest/gtest.h>
@@ -262,3 +271,172 @@ INSTANTIATE_TEST_SUITE_P(
           }
         return result;
       });
+
+TEST(bim_game_contest, measure_systems)
+{
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 1234,
+    .features = {},
+    .player_count = 2,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  bim::game::contest contest(fingerprint);
+  bim::game::system_timings timings;
+
+  contest.tick();
+
+  for (std::size_t i = 0; i != bim::game::system_timings::system_count; ++i)
+    EXPECT_EQ(0, timings.calls[i]) << bim::game::system_name(
+        (bim::game::system_id)i);
+
+  contest.measure_systems(&timings);
+  contest.tick();
+  contest.tick();
+
+  for (std::size_t i = 0; i != bim::game::system_timings::system_count; ++i)
+    EXPECT_EQ(2, timings.calls[i]) << bim::game::system_name(
+        (bim::game::system_id)i);
+
+  contest.measure_systems(nullptr);
+  contest.tick();
+
+  for (std::size_t i = 0; i != bim::game::system_timings::system_count; ++i)
+    EXPECT_EQ(2, timings.calls[i]) << bim::game::system_name(
+        (bim::game::system_id)i);
+}
+
+static void play_with_bots(bim::game::contest& contest,
+                           std::uint8_t player_count, int tick_count)
+{
+  bim::game::tests::bot_players(contest, player_count, 0)
+      .run(contest, tick_count);
+}
+
+static void expect_same_contests(const bim::game::contest& expected,
+                                 const bim::game::contest& contest)
+{
+  bim::game::archive_storage expected_archive;
+  bim::game::serialize_state(expected_archive, expected.registry());
+
+  bim::game::archive_storage archive;
+  bim::game::serialize_state(archive, contest.registry());
+
+  EXPECT_EQ(expected_archive, archive);
+  EXPECT_EQ(expected.state_checksum(), contest.state_checksum());
+
+  const bim::game::arena& expected_arena = expected.arena();
+  const bim::game::arena& arena = contest.arena();
+
+  ASSERT_EQ(expected_arena.width(), arena.width());
+  ASSERT_EQ(expected_arena.height(), arena.height());
+  EXPECT_EQ(expected_arena.static_walls().size(),
+            arena.static_walls().size());
+
+  for (int y = 0; y != arena.height(); ++y)
+    for (int x = 0; x != arena.width(); ++x)
+      {
+        EXPECT_EQ(expected_arena.is_static_wall(x, y),
+                  arena.is_static_wall(x, y))
+            << "x=" << x << ", y=" << y;
+        EXPECT_EQ(expected_arena.fences(x, y), arena.fences(x, y))
+            << "x=" << x << ", y=" << y;
+        EXPECT_TRUE(std::ranges::equal(expected.entity_map().entities_at(x, y),
+                                       contest.entity_map().entities_at(x, y)))
+            << "x=" << x << ", y=" << y;
+      }
+}
+
+TEST(bim_game_contest, reset)
+{
+  bim::game::feature_flags features{};
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    features = features | f;
+
+  const bim::game::contest_fingerprint first_fingerprint = {
+    .seed = 1234,
+    .features = features,
+    .player_count = 4,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 4321,
+    .features = bim::game::feature_flags::fences,
+    .player_count = 3,
+    .crate_probability = 60,
+    .arena_width = 11,
+    .arena_height = 9
+  };
+
+  bim::game::contest contest(first_fingerprint);
+  play_with_bots(contest, first_fingerprint.player_count, 500);
+
+  // A reset contest must be exactly like a new one, and must evolve the same
+  // way.
+  contest.reset(fingerprint);
+
+  bim::game::contest expected(fingerprint);
+  expect_same_contests(expected, contest);
+
+  play_with_bots(contest, fingerprint.player_count, 200);
+  play_with_bots(expected, fingerprint.player_count, 200);
+  expect_same_contests(expected, contest);
+}
+
+TEST(bim_game_contest, pool)
+{
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 1234,
+    .features = {},
+    .player_count = 2,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  bim::game::contest_pool pool(1);
+  EXPECT_EQ(0, pool.size());
+
+  std::unique_ptr<bim::game::contest> first = pool.acquire(fingerprint);
+  std::unique_ptr<bim::game::contest> second = pool.acquire(fingerprint);
+  bim::game::contest* const first_address = first.get();
+
+  play_with_bots(*first, fingerprint.player_count, 100);
+
+  pool.release(std::move(first));
+  EXPECT_EQ(1, pool.size());
+
+  // Above the maximum size, the contest is dropped.
+  pool.release(std::move(second));
+  EXPECT_EQ(1, pool.size());
+
+  std::unique_ptr<bim::game::contest> third = pool.acquire(fingerprint);
+  EXPECT_EQ(first_address, third.get());
+  EXPECT_EQ(0, pool.size());
+
+  expect_same_contests(bim::game::contest(fingerprint), *third);
+}
+
+TEST(bim_game_contest, shared_context)
+{
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 1234,
+    .features = {},
+    .player_count = 2,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  const bim::game::contest first(fingerprint);
+  const bim::game::contest second(fingerprint);
+
+  EXPECT_EQ(&first.context(), &second.context());
+  EXPECT_EQ(&bim::game::shared_context(), &first.context());
+}
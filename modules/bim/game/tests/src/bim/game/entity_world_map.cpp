@@ -5,6 +5,7 @@
 #include <entt/entity/registry.hpp>
 
 #include <algorithm>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -74,3 +75,36 @@ TEST(bim_game_entity_world_map, erase)
   EXPECT_NE(span.end(), std::ranges::find(span, entities[1]));
   EXPECT_NE(span.end(), std::ranges::find(span, entities[5]));
 }
+
+TEST(bim_game_entity_world_map, many_entities_in_a_cell)
+{
+  entt::registry registry;
+
+  std::vector<entt::entity> entities(20);
+  registry.create(entities.begin(), entities.end());
+
+  bim::game::entity_world_map map(2, 2);
+
+  map.put_entity(entities[0], 0, 0);
+  map.put_entity(entities[1], 1, 1);
+
+  for (std::size_t i = 2; i != entities.size(); ++i)
+    map.put_entity(entities[i], 1, 0);
+
+  const bim::game::entity_world_map copy = map;
+
+  for (const bim::game::entity_world_map* m : { &map, &copy })
+    {
+      ASSERT_EQ(1, m->entities_at(0, 0).size());
+      EXPECT_EQ(entities[0], m->entities_at(0, 0)[0]);
+
+      EXPECT_EQ(0, m->entities_at(0, 1).size());
+
+      ASSERT_EQ(1, m->entities_at(1, 1).size());
+      EXPECT_EQ(entities[1], m->entities_at(1, 1)[0]);
+
+      // The entities are kept in insertion order.
+      const std::span<const entt::entity> span = m->entities_at(1, 0);
+      EXPECT_TRUE(std::ranges::equal(span, std::span(entities).subspan(2)));
+    }
+}
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #include <bim/game/game_state_checksum.hpp>
 
+#include <bim/game/tests/bot_players.hpp>
+
 #include <bim/game/component/bomb.hpp>
 #include <bim/game/component/dead.hpp>
 #include <bim/game/component/flame.hpp>
@@ -9,10 +11,18 @@
 #include <bim/game/component/player.hpp>
 #include <bim/game/component/position_on_grid.hpp>
 #include <bim/game/component/timer.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/contest_result.hpp>
+#include <bim/game/feature_flags.hpp>
 #include <bim/game/game_state_serialization.hpp>
+#include <bim/game/game_state_snapshot.hpp>
 
 #include <entt/entity/registry.hpp>
 
+#include <vector>
+
 #include <gtest/gtest.h>
 
 TEST(bim_game_game_state_checksum, compare_serialization_checksum)
@@ -62,3 +72,158 @@ TEST(bim_game_game_state_checksum, compare_serialization_checksum)
 
   EXPECT_EQ(checksum_a, checksum_b);
 }
+
+TEST(bim_game_game_state_checksum, incremental)
+{
+  entt::registry registry;
+  bim::game::incremental_game_state_checksum incremental(registry);
+
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  const entt::entity entities[] = { registry.create(), registry.create(),
+                                    registry.create(), registry.create() };
+
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  registry.emplace<bim::game::bomb>(entities[0], 18);
+  registry.emplace<bim::game::timer>(entities[0],
+                                     std::chrono::milliseconds(2));
+  registry.emplace<bim::game::invisibility_state>(entities[1], entities[3]);
+  registry.emplace<bim::game::position_on_grid>(entities[1], 11, 22);
+  registry.emplace<bim::game::player>(entities[1], 24, 0, 0, 4);
+  registry.emplace<bim::game::flame>(entities[3],
+                                     bim::game::flame_direction::left,
+                                     bim::game::flame_segment::tip);
+  registry.emplace<bim::game::dead>(entities[2]);
+
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  bim::game::archive_storage archive;
+  bim::game::serialize_state(archive, registry);
+
+  // In-place modifications.
+  registry.get<bim::game::timer>(entities[0]).duration =
+      std::chrono::milliseconds(1);
+  registry.get<bim::game::position_on_grid>(entities[1]).x = 3;
+
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  registry.remove<bim::game::dead>(entities[2]);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  registry.destroy(entities[1]);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  const entt::entity e = registry.create();
+  registry.emplace<bim::game::bomb>(e, 53);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  bim::game::deserialize_state(registry, archive);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  registry.clear();
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+}
+
+/**
+ * The archives contain the released entities too, which are created by the
+ * loaders then released without notification.
+ */
+TEST(bim_game_game_state_checksum, incremental_load_released_entities)
+{
+  entt::registry registry;
+  bim::game::incremental_game_state_checksum incremental(registry);
+
+  const entt::entity entities[] = { registry.create(), registry.create(),
+                                    registry.create(), registry.create(),
+                                    registry.create() };
+
+  registry.emplace<bim::game::bomb>(entities[0], 18);
+  registry.emplace<bim::game::position_on_grid>(entities[1], 11, 22);
+  registry.emplace<bim::game::flame>(entities[4],
+                                     bim::game::flame_direction::left,
+                                     bim::game::flame_segment::tip);
+
+  // Like the bombs and the flames in a game.
+  registry.destroy(entities[2]);
+  registry.destroy(entities[4]);
+
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  bim::game::archive_storage archive;
+  bim::game::serialize_state(archive, registry);
+
+  bim::game::game_state_snapshot snapshot;
+  snapshot.save(registry);
+
+  const std::uint32_t saved_checksum = incremental.value();
+
+  // Recycle an entity and create a new one, such that the snapshot cannot be
+  // restored in place.
+  registry.emplace<bim::game::bomb>(registry.create(), 53);
+  registry.create();
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  bim::game::deserialize_state(registry, archive);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+  EXPECT_EQ(saved_checksum, incremental.value());
+
+  // The hooks still work after the load.
+  registry.destroy(entities[1]);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  registry.emplace<bim::game::bomb>(registry.create(), 53);
+  registry.create();
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+
+  snapshot.restore(registry);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+  EXPECT_EQ(saved_checksum, incremental.value());
+
+  registry.destroy(entities[0]);
+  EXPECT_EQ(bim::game::game_state_checksum(registry), incremental.value());
+}
+
+TEST(bim_game_game_state_checksum, incremental_in_contest)
+{
+  std::vector<bim::game::feature_flags> all_feature_flags_combined;
+  all_feature_flags_combined.push_back({});
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    for (std::size_t i = 0, n = all_feature_flags_combined.size(); i != n; ++i)
+      all_feature_flags_combined.push_back(all_feature_flags_combined[i] | f);
+
+  constexpr std::uint8_t player_count = 4;
+
+  for (const bim::game::feature_flags features : all_feature_flags_combined)
+    {
+      const bim::game::contest_fingerprint fingerprint = {
+        .seed = 1234,
+        .features = features,
+        .player_count = player_count,
+        .crate_probability = 50,
+        .arena_width = bim::game::g_default_arena_width,
+        .arena_height = bim::game::g_default_arena_height
+      };
+
+      bim::game::contest contest(fingerprint);
+
+      bim::game::tests::bot_players bots(contest, player_count,
+                                         fingerprint.seed);
+
+      EXPECT_EQ(bim::game::game_state_checksum(contest.registry()),
+                contest.state_checksum());
+
+      for (int tick = 0; tick != 1000; ++tick)
+        {
+          const bool still_running = bots.tick(contest).still_running();
+
+          ASSERT_EQ(bim::game::game_state_checksum(contest.registry()),
+                    contest.state_checksum())
+              << "features=" << (int)features << ", tick=" << tick;
+
+          if (!still_running)
+            break;
+        }
+    }
+}
@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/game_state_snapshot.hpp>
+
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/component/bomb.hpp>
+#include <bim/game/component/player.hpp>
+#include <bim/game/component/position_on_grid.hpp>
+#include <bim/game/component/timer.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/entity_world_map.hpp>
+#include <bim/game/feature_flags.hpp>
+#include <bim/game/game_state_checksum.hpp>
+#include <bim/game/game_state_serialization.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <gtest/gtest.h>
+
+TEST(bim_game_game_state_snapshot, restore_in_place)
+{
+  entt::registry registry;
+  const entt::entity entities[] = { registry.create(), registry.create(),
+                                    registry.create() };
+
+  registry.emplace<bim::game::bomb>(entities[0], 18);
+  registry.emplace<bim::game::timer>(entities[0],
+                                     std::chrono::milliseconds(2));
+  registry.emplace<bim::game::position_on_grid>(entities[1], 11, 22);
+  registry.emplace<bim::game::position_on_grid>(entities[2], 33, 44);
+
+  bim::game::archive_storage expected;
+  bim::game::serialize_state(expected, registry);
+
+  bim::game::game_state_snapshot snapshot;
+  snapshot.save(registry);
+
+  registry.get<bim::game::bomb>(entities[0]).strength = 2;
+  registry.get<bim::game::position_on_grid>(entities[2]).x = 1;
+  registry.remove<bim::game::timer>(entities[0]);
+  registry.remove<bim::game::position_on_grid>(entities[1]);
+  registry.emplace<bim::game::position_on_grid>(entities[1], 55, 66);
+
+  snapshot.restore(registry);
+
+  bim::game::archive_storage restored;
+  bim::game::serialize_state(restored, registry);
+
+  EXPECT_EQ(expected, restored);
+
+  // Destroying an entity and creating a new one must restore the initial
+  // entities too, otherwise the next created entities would be different.
+  registry.destroy(entities[1]);
+  registry.emplace<bim::game::player>(registry.create(), 1, 2, 3, 4);
+
+  snapshot.restore(registry);
+  bim::game::serialize_state(restored, registry);
+
+  EXPECT_EQ(expected, restored);
+}
+
+static void count_destroyed_bombs(int& count, entt::registry&, entt::entity)
+{
+  ++count;
+}
+
+TEST(bim_game_game_state_snapshot, keep_components_of_other_entities)
+{
+  entt::registry registry;
+  const entt::entity entities[] = { registry.create(), registry.create(),
+                                    registry.create() };
+
+  registry.emplace<bim::game::bomb>(entities[0], 18);
+  registry.emplace<bim::game::position_on_grid>(entities[1], 11, 22);
+  registry.emplace<bim::game::position_on_grid>(entities[2], 33, 44);
+
+  bim::game::archive_storage expected;
+  bim::game::serialize_state(expected, registry);
+
+  bim::game::game_state_snapshot snapshot;
+  snapshot.save(registry);
+
+  int destroyed_bomb_count = 0;
+  registry.on_destroy<bim::game::bomb>().connect<&count_destroyed_bombs>(
+      destroyed_bomb_count);
+
+  const bim::game::bomb* const bomb =
+      &registry.get<bim::game::bomb>(entities[0]);
+
+  registry.destroy(entities[2]);
+  registry.emplace<bim::game::position_on_grid>(registry.create(), 55, 66);
+
+  snapshot.restore(registry);
+
+  bim::game::archive_storage restored;
+  bim::game::serialize_state(restored, registry);
+
+  EXPECT_EQ(expected, restored);
+
+  // The storage of the bombs did not change since the save, it must not have
+  // been rebuilt.
+  EXPECT_EQ(0, destroyed_bomb_count);
+  EXPECT_EQ(bomb, &registry.get<bim::game::bomb>(entities[0]));
+
+  // The next entity must be the same than in the saved registry.
+  entt::registry saved_registry;
+  bim::game::deserialize_state(saved_registry, expected);
+
+  EXPECT_EQ(saved_registry.create(), registry.create());
+
+  registry.on_destroy<bim::game::bomb>().disconnect(destroyed_bomb_count);
+}
+
+TEST(bim_game_game_state_snapshot, rollback_in_contest)
+{
+  bim::game::feature_flags features{};
+
+  for (const bim::game::feature_flags f : bim::game::g_all_game_feature_flags)
+    features = features | f;
+
+  constexpr std::uint8_t player_count = 4;
+
+  const bim::game::contest_fingerprint fingerprint = {
+    .seed = 4321,
+    .features = features,
+    .player_count = player_count,
+    .crate_probability = 50,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+
+  bim::game::contest contest(fingerprint);
+  entt::registry& registry = contest.registry();
+
+  bim::game::tests::bot_players bots(contest, player_count, fingerprint.seed);
+
+  bim::game::game_state_snapshot snapshot;
+  bim::game::archive_storage saved_archive;
+  bim::game::archive_storage predicted_archive;
+  bim::game::archive_storage archive;
+
+  constexpr int rollback_length = 5;
+  bool still_running = true;
+
+  for (int tick = 0; still_running && (tick < 1000); tick += rollback_length)
+    {
+      snapshot.save(registry);
+      bim::game::serialize_state(saved_archive, registry);
+
+      const std::uint32_t saved_checksum = contest.state_checksum();
+      const bim::game::entity_world_map saved_entity_map =
+          contest.entity_map();
+      const bim::game::tests::bot_players saved_bots = bots;
+
+      const bool predicted_still_running = bots.run(contest, rollback_length);
+      bim::game::serialize_state(predicted_archive, registry);
+
+      snapshot.restore(registry);
+      contest.entity_map(saved_entity_map);
+      bots = saved_bots;
+
+      bim::game::serialize_state(archive, registry);
+      ASSERT_EQ(saved_archive, archive) << "tick=" << tick;
+      EXPECT_EQ(saved_checksum, contest.state_checksum()) << "tick=" << tick;
+      EXPECT_EQ(bim::game::game_state_checksum(registry),
+                contest.state_checksum())
+          << "tick=" << tick;
+
+      // Simulating the same ticks from the restored state must produce the
+      // same state than before the rollback.
+      still_running = bots.run(contest, rollback_length);
+      EXPECT_EQ(predicted_still_running, still_running) << "tick=" << tick;
+
+      bim::game::serialize_state(archive, registry);
+      ASSERT_EQ(predicted_archive, archive) << "tick=" << tick;
+    }
+}
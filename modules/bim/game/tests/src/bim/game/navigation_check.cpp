@@ -5,8 +5,13 @@
 #include <bim/game/cell_edge.hpp>
 #include <bim/game/cell_neighborhood.hpp>
 #include <bim/game/component/position_on_grid.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/context/context.hpp>
+#include <bim/game/context/fill_context.hpp>
 #include <bim/game/entity_world_map.hpp>
 #include <bim/game/factory/wall.hpp>
+#include <bim/game/level_generation.hpp>
+#include <bim/game/random_generator.hpp>
 
 #include <bim/table_2d.impl.hpp>
 
@@ -712,3 +717,124 @@ TEST(bim_game_navigation_check, exists)
   ASSERT_TRUE(nav.exists(registry, arena, entity_map, 3, 0, 5, forbidden));
   ASSERT_TRUE(nav.exists(registry, arena, entity_map, 3, 0, 50, forbidden));
 }
+
+TEST(bim_game_navigation_check, bitboard_matches_best_first)
+{
+  const int arena_width = bim::game::g_default_arena_width;
+  const int arena_height = bim::game::g_default_arena_height;
+
+  bim::game::arena arena(arena_width, arena_height);
+  bim::game::entity_world_map entity_map(arena_width, arena_height);
+  entt::registry registry;
+
+  bim::game::generate_basic_level_structure(arena);
+
+  ASSERT_TRUE(bim::game::navigation_check::fits_in_bitboard(arena));
+
+  bim::game::context context;
+  bim::game::fill_context(context);
+
+  bim::game::random_generator random(1234);
+  bim::game::insert_random_crates(context, arena, entity_map, registry, random,
+                                  30, {}, {});
+
+  arena.add_fence(1, 1, bim::game::cell_edge::right);
+  arena.add_fence(3, 1, bim::game::cell_edge::down);
+  arena.add_fence(1, 5, bim::game::cell_edge::up);
+
+  bim::table_2d<bool> allowed(arena_width, arena_height);
+
+  for (int y = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x)
+      allowed(x, y) = (x * 7 + y * 3) % 11 != 0;
+
+  bim::game::navigation_check best_first(
+      bim::game::navigation_check::algorithm::best_first);
+  bim::game::navigation_check bitboard(
+      bim::game::navigation_check::algorithm::bitboard);
+
+  bim::table_2d<std::uint8_t> best_first_distance(arena_width, arena_height);
+  bim::table_2d<std::uint8_t> bitboard_distance(arena_width, arena_height);
+  bim::table_2d<bim::game::position_on_grid> previous(arena_width,
+                                                      arena_height);
+
+  for (int y = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x)
+      {
+        if (arena.is_static_wall(x, y))
+          continue;
+
+        for (int ty = 0; ty != arena_height; ++ty)
+          for (int tx = 0; tx != arena_width; ++tx)
+            ASSERT_EQ(best_first.reachable(arena, x, y, tx, ty),
+                      bitboard.reachable(arena, x, y, tx, ty))
+                << "x=" << x << ", y=" << y << ", tx=" << tx << ", ty=" << ty;
+
+        for (int d = 0; d != 10; ++d)
+          ASSERT_EQ(best_first.exists(registry, arena, entity_map, x, y, d,
+                                      allowed),
+                    bitboard.exists(registry, arena, entity_map, x, y, d,
+                                    allowed))
+              << "x=" << x << ", y=" << y << ", d=" << d;
+
+        best_first.paths(best_first_distance, previous, registry, arena,
+                         entity_map, x, y, allowed);
+        bitboard.paths(bitboard_distance, previous, registry, arena,
+                       entity_map, x, y, allowed);
+
+        for (int py = 0; py != arena_height; ++py)
+          for (int px = 0; px != arena_width; ++px)
+            {
+              const std::uint8_t d = bitboard_distance(px, py);
+              ASSERT_EQ(best_first_distance(px, py), d)
+                  << "x=" << x << ", y=" << y << ", px=" << px
+                  << ", py=" << py;
+
+              if ((d == 0) || (d >= bim::game::navigation_check::unreachable))
+                continue;
+
+              // The previous cell may differ from the one of the best-first
+              // search, but it must be one step closer to the start.
+              const bim::game::position_on_grid p = previous(px, py);
+              EXPECT_EQ(1, std::abs(p.x - px) + std::abs(p.y - py));
+
+              // The distance of the start cell may have been replaced by
+              // border if it is not allowed.
+              if (d == 1)
+                EXPECT_EQ(bim::game::position_on_grid(x, y), p);
+              else
+                EXPECT_EQ(d - 1, bitboard_distance(p.x, p.y));
+            }
+      }
+}
+
+TEST(bim_game_navigation_check, bitboard_arena_changes)
+{
+  constexpr int arena_width = 5;
+  constexpr int arena_height = 3;
+  bim::game::arena arena(arena_width, arena_height);
+
+  bim::game::navigation_check nav(
+      bim::game::navigation_check::algorithm::bitboard);
+
+  EXPECT_TRUE(nav.reachable(arena, 0, 0, 4, 0));
+
+  // The moves computed for the arena must be updated when a fence is added.
+  for (int y = 0; y != arena_height; ++y)
+    arena.add_fence(1, y, bim::game::cell_edge::right);
+
+  EXPECT_FALSE(nav.reachable(arena, 0, 0, 4, 0));
+  EXPECT_TRUE(nav.reachable(arena, 0, 0, 1, 2));
+
+  arena.remove_fence(1, 1, bim::game::cell_edge::right);
+  EXPECT_TRUE(nav.reachable(arena, 0, 0, 4, 0));
+
+  // Same for a wall.
+  arena.set_static_wall(2, 1, bim::game::cell_neighborhood::none);
+  EXPECT_FALSE(nav.reachable(arena, 0, 0, 4, 0));
+
+  // And for another arena of the same size.
+  const bim::game::arena other_arena(arena_width, arena_height);
+  EXPECT_TRUE(nav.reachable(other_arena, 0, 0, 4, 0));
+  EXPECT_FALSE(nav.reachable(arena, 0, 0, 4, 0));
+}
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/player_table.hpp>
+
+#include <bim/game/component/fractional_position_on_grid.hpp>
+#include <bim/game/component/player.hpp>
+#include <bim/game/component/player_action.hpp>
+#include <bim/game/component/player_action_queue.hpp>
+#include <bim/game/entity_world_map.hpp>
+#include <bim/game/factory/player.hpp>
+#include <bim/game/game_state_serialization.hpp>
+#include <bim/game/game_state_snapshot.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <gtest/gtest.h>
+
+static void expect_same_players(const bim::game::player_table& table,
+                                entt::registry& registry)
+{
+  std::size_t i = 0;
+
+  for (const auto& [entity, player, position, action, action_queue] :
+       registry
+           .view<bim::game::player, bim::game::fractional_position_on_grid,
+                 bim::game::player_action, bim::game::player_action_queue>()
+           .each())
+    {
+      ASSERT_LT(i, table.size());
+
+      EXPECT_EQ(entity, table.entities[i]) << "i=" << i;
+      EXPECT_EQ(&player, table.players[i]) << "i=" << i;
+      EXPECT_EQ(&position, table.positions[i]) << "i=" << i;
+      EXPECT_EQ(&action, table.actions[i]) << "i=" << i;
+      EXPECT_EQ(&action_queue, table.action_queues[i]) << "i=" << i;
+      ++i;
+    }
+
+  EXPECT_EQ(i, table.size());
+}
+
+TEST(bim_game_player_table, follows_the_registry)
+{
+  entt::registry registry;
+  bim::game::entity_world_map entity_map(3, 3);
+  bim::game::player_table table(registry);
+
+  table.refresh();
+  EXPECT_EQ(0, table.size());
+
+  const entt::entity player_0 = bim::game::player_factory(
+      registry, entity_map, 0, 0, 0, bim::game::animation_id{});
+  bim::game::player_factory(registry, entity_map, 1, 1, 1,
+                            bim::game::animation_id{});
+
+  table.refresh();
+  expect_same_players(table, registry);
+  EXPECT_EQ(2, table.size());
+
+  const entt::entity player_2 = bim::game::player_factory(
+      registry, entity_map, 2, 2, 2, bim::game::animation_id{});
+
+  table.refresh();
+  expect_same_players(table, registry);
+  EXPECT_EQ(3, table.size());
+
+  // The components of the last player are moved in the place of the first.
+  registry.destroy(player_0);
+
+  table.refresh();
+  expect_same_players(table, registry);
+  EXPECT_EQ(2, table.size());
+
+  // Without an action queue this entity is not a player for the table.
+  registry.remove<bim::game::player_action_queue>(player_2);
+
+  table.refresh();
+  expect_same_players(table, registry);
+  EXPECT_EQ(1, table.size());
+}
+
+TEST(bim_game_player_table, rebuilt_after_deserialization)
+{
+  entt::registry registry;
+  bim::game::entity_world_map entity_map(3, 3);
+  bim::game::player_table table(registry);
+
+  bim::game::player_factory(registry, entity_map, 0, 0, 0,
+                            bim::game::animation_id{});
+  const entt::entity player_1 = bim::game::player_factory(
+      registry, entity_map, 1, 1, 1, bim::game::animation_id{});
+  registry.get<bim::game::player>(player_1).bomb_strength = 4;
+
+  bim::game::archive_storage archive;
+  bim::game::serialize_state(archive, registry);
+
+  registry.destroy(player_1);
+  table.refresh();
+  EXPECT_EQ(1, table.size());
+
+  bim::game::deserialize_state(registry, archive);
+
+  table.refresh();
+  expect_same_players(table, registry);
+  ASSERT_EQ(2, table.size());
+
+  const std::size_t i = (table.entities[0] == player_1) ? 0 : 1;
+  EXPECT_EQ(player_1, table.entities[i]);
+  EXPECT_EQ(4, table.players[i]->bomb_strength);
+}
+
+TEST(bim_game_player_table, rebuilt_after_snapshot_restore)
+{
+  entt::registry registry;
+  bim::game::entity_world_map entity_map(3, 3);
+  bim::game::player_table table(registry);
+
+  const entt::entity player_0 = bim::game::player_factory(
+      registry, entity_map, 0, 0, 0, bim::game::animation_id{});
+  bim::game::player_factory(registry, entity_map, 1, 1, 1,
+                            bim::game::animation_id{});
+
+  bim::game::game_state_snapshot snapshot;
+  snapshot.save(registry);
+
+  table.refresh();
+  registry.destroy(player_0);
+  bim::game::player_factory(registry, entity_map, 2, 2, 2,
+                            bim::game::animation_id{});
+  table.refresh();
+
+  snapshot.restore(registry);
+
+  table.refresh();
+  expect_same_players(table, registry);
+  ASSERT_EQ(2, table.size());
+
+  // Modifying the components in place keeps the table valid.
+  table.positions[0]->x += 1;
+  snapshot.restore(registry);
+
+  table.refresh();
+  expect_same_players(table, registry);
+  EXPECT_EQ(2, table.size());
+}
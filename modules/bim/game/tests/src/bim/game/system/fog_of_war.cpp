@@ -1,12 +1,16 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #include <bim/game/entity_world_map.hpp>
 
+#include <bim/game/arena.hpp>
 #include <bim/game/cell_neighborhood.hpp>
 #include <bim/game/component/fog_of_war.hpp>
+#include <bim/game/component/fractional_position_on_grid.hpp>
 #include <bim/game/component/player.hpp>
 #include <bim/game/component/position_on_grid.hpp>
 #include <bim/game/factory/fog_of_war.hpp>
 #include <bim/game/factory/player.hpp>
+#include <bim/game/system/fog_of_war_updater.hpp>
+#include <bim/game/system/update_timers.hpp>
 
 #include <bim/table_2d.impl.hpp>
 
@@ -305,3 +309,103 @@ TEST(fog_of_war, excluded)
               | bim::game::cell_neighborhood::up_right),
             neighborhood(4, 6));
 }
+
+TEST(fog_of_war, updater)
+{
+  entt::registry registry;
+
+  constexpr int arena_width = 5;
+  constexpr int arena_height = 7;
+  const bim::game::arena arena(arena_width, arena_height);
+  bim::game::entity_world_map entity_map(arena_width, arena_height);
+
+  const entt::entity player = bim::game::player_factory(
+      registry, entity_map, 0, 0, 0, bim::game::animation_id{});
+
+  bim::game::fog_of_war_factory(registry, 0, arena_width, arena_height, {});
+  bim::game::fog_of_war_updater updater(arena, 1);
+
+  // Let the fog roll in.
+  bim::game::update_timers(registry, std::chrono::seconds(1));
+  updater.update(registry);
+
+  const bim::table_2d<bim::game::fog_of_war*>& fog = updater.fog(0);
+
+  for (int y = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x)
+      if (fog(x, y))
+        {
+          EXPECT_EQ(bim::game::fog_state::stable, fog(x, y)->state)
+              << "x=" << x << ", y=" << y;
+          EXPECT_EQ(bim::game::fog_of_war::full_opacity, fog(x, y)->opacity)
+              << "x=" << x << ", y=" << y;
+        }
+
+  const bim::table_2d<bim::game::cell_neighborhood> initial_neighborhood =
+      fog_map(arena_width, arena_height, registry);
+
+  /*
+    The player moves in the fog, the fog around it is removed.
+
+      Fog
+    0 ..fff
+    1 ..fff
+    2 .hhhf
+    3 fhhhf
+    4 fhhhf
+    5 fffff
+    6 fffff
+  */
+  registry.get<bim::game::fractional_position_on_grid>(player) =
+      bim::game::fractional_position_on_grid(std::uint8_t(2), std::uint8_t(3));
+
+  for (int i = 0; i != 10; ++i)
+    {
+      bim::game::update_timers(registry, std::chrono::milliseconds(20));
+      updater.update(registry);
+    }
+
+  for (int y = 0; y != arena_height; ++y)
+    for (int x = 0; x != arena_width; ++x)
+      {
+        if (!fog(x, y))
+          continue;
+
+        const bool hidden = (x >= 1) && (x <= 3) && (y >= 2) && (y <= 4);
+
+        if (hidden)
+          {
+            EXPECT_EQ(bim::game::fog_state::hiding, fog(x, y)->state)
+                << "x=" << x << ", y=" << y;
+            EXPECT_EQ(0, fog(x, y)->opacity) << "x=" << x << ", y=" << y;
+          }
+        else
+          {
+            EXPECT_EQ(bim::game::fog_state::stable, fog(x, y)->state)
+                << "x=" << x << ", y=" << y;
+            EXPECT_EQ(bim::game::fog_of_war::full_opacity, fog(x, y)->opacity)
+                << "x=" << x << ", y=" << y;
+          }
+      }
+
+  const bim::table_2d<bim::game::cell_neighborhood> neighborhood =
+      fog_map(arena_width, arena_height, registry);
+
+  // Not neighbor of the hidden cells.
+  EXPECT_EQ(initial_neighborhood(4, 0), neighborhood(4, 0));
+  EXPECT_EQ(initial_neighborhood(0, 6), neighborhood(0, 6));
+
+  EXPECT_EQ(initial_neighborhood(2, 1)
+                & ~(bim::game::cell_neighborhood::down_left
+                    | bim::game::cell_neighborhood::down
+                    | bim::game::cell_neighborhood::down_right),
+            neighborhood(2, 1));
+  EXPECT_EQ(initial_neighborhood(4, 3)
+                & ~(bim::game::cell_neighborhood::up_left
+                    | bim::game::cell_neighborhood::left
+                    | bim::game::cell_neighborhood::down_left),
+            neighborhood(4, 3));
+  EXPECT_EQ(initial_neighborhood(0, 5)
+                & ~bim::game::cell_neighborhood::up_right,
+            neighborhood(0, 5));
+}
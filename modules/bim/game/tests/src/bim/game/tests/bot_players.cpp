@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/game/tests/bot_players.hpp>
+
+#include <bim/game/arena.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_result.hpp>
+#include <bim/game/player_action.hpp>
+
+bim::game::tests::bot_players::bot_players(const contest& contest,
+                                           std::uint8_t player_count,
+                                           std::uint64_t seed)
+  : m_world(contest.arena().width(), contest.arena().height())
+{
+  m_bots.reserve(player_count);
+
+  for (int i = 0; i != player_count; ++i)
+    m_bots.emplace_back(i, contest.arena().width(), contest.arena().height(),
+                        seed + i);
+}
+
+bim::game::tests::bot_players::~bot_players() = default;
+
+void bim::game::tests::bot_players::think(contest& contest)
+{
+  m_world.update(contest);
+
+  for (bot& bot : m_bots)
+    {
+      player_action* const action = find_player_action_by_index(
+          contest.registry(), bot.player_index());
+
+      if (action)
+        *action = bot.think(contest, m_world);
+    }
+}
+
+bim::game::contest_result
+bim::game::tests::bot_players::tick(contest& contest)
+{
+  think(contest);
+  return contest.tick();
+}
+
+bool bim::game::tests::bot_players::run(contest& contest, int tick_count)
+{
+  for (int i = 0; i != tick_count; ++i)
+    if (!tick(contest).still_running())
+      return false;
+
+  return true;
+}
@@ -3,9 +3,9 @@
 
 #include <bim/net/contest_result.hpp>
 
-#include <bim/game/archive_storage.hpp>
 #include <bim/game/constant/max_player_count.hpp>
 #include <bim/game/entity_world_map.hpp>
+#include <bim/game/game_state_snapshot.hpp>
 #include <bim/game/tick_counter.hpp>
 
 #include <entt/entity/fwd.hpp>
@@ -34,15 +34,29 @@ namespace bim::net
     std::uint32_t local_tick() const;
     std::uint32_t confirmed_tick() const;
 
+    /**
+     * The number of times the contest has been put back in its last
+     * confirmed state to replay the actions received from the server.
+     */
+    std::uint32_t rollback_count() const;
+
     contest_result run(std::chrono::nanoseconds elapsed_wall_time);
 
+    /**
+     * Store the actions received from the server, to be applied in the next
+     * call to run(). This is called for each update received by the
+     * game_update_exchange passed to the constructor.
+     */
+    void queue_updates(const server_update& updates);
+
   private:
     struct history_entry;
 
   private:
-    void queue_updates(const server_update& updates);
 
     void sync_with_server(entt::registry& registry);
+    bool server_actions_match_predictions(std::size_t tick_count) const;
+    void confirm_predictions(entt::registry& registry, std::size_t tick_count);
     void restore_last_confirmed_state(entt::registry& registry);
     void apply_server_actions(entt::registry& registry);
     void save_contest_state(entt::registry& registry);
@@ -52,9 +66,6 @@ namespace bim::net
         entt::registry& registry,
         const bim::game::player_action& local_player_action);
 
-    template <typename Archive, typename Snapshot>
-    void archive_io(Snapshot&& snapshot, Archive&& archive) const;
-
   private:
     const std::uint8_t m_local_player_index;
     const std::uint8_t m_player_count;
@@ -69,15 +80,32 @@ namespace bim::net
         m_server_actions;
     std::uint32_t m_server_checksum;
 
+    /// The tick of the last saved state.
     std::uint32_t m_confirmed_tick_count;
+
+    /**
+     * The number of ticks at the beginning of m_server_actions that have been
+     * simulated with the same actions than the ones received from the server.
+     * They are confirmed but the corresponding state has not been saved.
+     */
+    std::uint32_t m_verified_tick_count;
+
+    /// The checksum of the state at tick confirmed_tick().
     std::uint32_t m_last_confirmed_checksum;
     std::uint32_t m_completed_tick_count;
+    std::uint32_t m_rollback_count;
 
     std::array<std::vector<bim::game::player_action>,
                bim::game::g_max_player_count>
         m_unconfirmed_actions;
 
-    bim::game::archive_storage m_last_confirmed_archive;
+    /**
+     * The checksum of the state after each of the unconfirmed actions of the
+     * local player.
+     */
+    std::vector<std::uint32_t> m_predicted_checksums;
+
+    bim::game::game_state_snapshot m_last_confirmed_state;
     bim::game::entity_world_map m_last_confirmed_entity_map;
 
     std::optional<contest_result> m_contest_result;
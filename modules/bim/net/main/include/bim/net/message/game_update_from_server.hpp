@@ -4,13 +4,24 @@
 #include <bim/net/message/message_type.hpp>
 
 #include <bim/game/component/player_action.hpp>
+#include <bim/game/per_player_array.hpp>
 
 #include <iscool/net/message/raw_message.hpp>
 
+#include <boost/container/static_vector.hpp>
+
 namespace bim::net
 {
   class game_update_from_server
   {
+  public:
+    /// The action count of a player is serialized on a single byte.
+    static constexpr std::size_t max_action_count = 255;
+
+    using action_list =
+        boost::container::static_vector<bim::game::player_action,
+                                        max_action_count>;
+
   public:
     static iscool::net::message_type get_type()
     {
@@ -30,7 +41,12 @@ namespace bim::net
     /** Checksum of the game state at tick from_tick. */
     std::uint32_t final_checksum;
 
-    /** The actual actions, per player. */
-    std::vector<std::vector<bim::game::player_action>> actions;
+    std::uint8_t player_count;
+
+    /**
+     * The actual actions, per player. Only the first player_count entries are
+     * used.
+     */
+    bim::game::per_player_array<action_list> actions;
   };
 }
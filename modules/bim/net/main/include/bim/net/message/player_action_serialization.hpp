@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #pragma once
 
+#include <span>
+
 namespace iscool::net
 {
   class byte_array_bit_reader;
@@ -18,4 +20,20 @@ namespace bim::net
             iscool::net::byte_array_bit_reader& bits);
   void write(iscool::net::byte_array_bit_inserter& bits,
              const bim::game::player_action& action);
+
+  /**
+   * Read the actions written by write_runs(). The size of the span tells how
+   * many actions are expected.
+   */
+  void read_runs(std::span<bim::game::player_action> actions,
+                 iscool::net::byte_array_bit_reader& bits);
+
+  /**
+   * Write a sequence of actions as runs of identical actions: each run is
+   * the action followed by its length. Players usually keep the same action
+   * for many consecutive ticks, so this is much smaller than writing each
+   * action.
+   */
+  void write_runs(iscool::net::byte_array_bit_inserter& bits,
+                  std::span<const bim::game::player_action> actions);
 }
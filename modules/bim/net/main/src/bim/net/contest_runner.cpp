@@ -9,8 +9,6 @@
 #include <bim/game/component/player_action.hpp>
 #include <bim/game/constant/max_player_count.hpp>
 #include <bim/game/contest.hpp>
-#include <bim/game/game_state_checksum.hpp>
-#include <bim/game/game_state_serialization.hpp>
 #include <bim/game/kick_event.hpp>
 #include <bim/game/player_action.hpp>
 
@@ -31,7 +29,9 @@ bim::net::contest_runner::contest_runner(bim::game::contest& contest,
   , m_contest(contest)
   , m_update_exchange(update_exchange)
   , m_confirmed_tick_count(0)
+  , m_verified_tick_count(0)
   , m_completed_tick_count(0)
+  , m_rollback_count(0)
 {
   for (std::vector<bim::game::player_action>& server_actions :
        m_server_actions)
@@ -64,7 +64,12 @@ std::uint32_t bim::net::contest_runner::local_tick() const
 
 std::uint32_t bim::net::contest_runner::confirmed_tick() const
 {
-  return m_confirmed_tick_count;
+  return m_confirmed_tick_count + m_verified_tick_count;
+}
+
+std::uint32_t bim::net::contest_runner::rollback_count() const
+{
+  return m_rollback_count;
 }
 
 bim::net::contest_result
@@ -95,10 +100,10 @@ bim::net::contest_runner::run(std::chrono::nanoseconds elapsed_wall_time)
   for (int i = 0; i != tick_count; ++i)
     {
       apply_actions_for_current_tick(registry, player_current_action_copy);
-      m_update_exchange.push(player_current_action_copy,
-                             m_confirmed_tick_count,
+      m_update_exchange.push(player_current_action_copy, confirmed_tick(),
                              m_last_confirmed_checksum);
       m_contest.tick();
+      m_predicted_checksums.push_back(m_contest.state_checksum());
     }
 
   m_update_exchange.send();
@@ -137,40 +142,113 @@ void bim::net::contest_runner::sync_with_server(entt::registry& registry)
 {
   ZoneScoped;
 
-  restore_last_confirmed_state(registry);
+  std::size_t tick_count = 0;
 
-  bool has_action = false;
   for (const std::vector<bim::game::player_action>& actions : m_server_actions)
-    if (!actions.empty())
-      {
-        has_action = true;
-        break;
-      }
+    if (actions.size() > tick_count)
+      tick_count = actions.size();
+
+  // Without new actions from the server, restoring the last confirmed state
+  // and replaying the unconfirmed actions would give the current state.
+  if (tick_count == m_verified_tick_count)
+    return;
+
+  // Past this number of verified ticks we rebuild the state anyway, such that
+  // the rollbacks following a misprediction do not grow indefinitely.
+  constexpr std::size_t max_verified_tick_count =
+      std::chrono::seconds(1) / bim::game::contest::tick_interval;
 
-  if (has_action)
+  if ((tick_count <= max_verified_tick_count)
+      && server_actions_match_predictions(tick_count))
     {
-      apply_server_actions(registry);
-      save_contest_state(registry);
+      confirm_predictions(registry, tick_count);
+      return;
+    }
 
-      if (m_last_confirmed_checksum != m_server_checksum)
-        ic_log(iscool::log::nature::info(), "contest_runner",
-               "Desynchronized. Last confirmed tick={} with local "
-               "checksum=0x{:08x} and remote checksum=0x{:08x}.",
-               m_confirmed_tick_count - 1, m_last_confirmed_checksum,
-               m_server_checksum);
+  ++m_rollback_count;
+  restore_last_confirmed_state(registry);
+  apply_server_actions(registry);
+  save_contest_state(registry);
 
-      assert(m_last_confirmed_checksum == m_server_checksum);
+  if (m_last_confirmed_checksum != m_server_checksum)
+    ic_log(iscool::log::nature::info(), "contest_runner",
+           "Desynchronized. Last confirmed tick={} with local "
+           "checksum=0x{:08x} and remote checksum=0x{:08x}.",
+           m_confirmed_tick_count - 1, m_last_confirmed_checksum,
+           m_server_checksum);
 
-      drop_confirmed_actions();
-    }
+  assert(m_last_confirmed_checksum == m_server_checksum);
 
+  drop_confirmed_actions();
   apply_unconfirmed_actions();
 }
 
+bool bim::net::contest_runner::server_actions_match_predictions(
+    std::size_t tick_count) const
+{
+  const std::vector<bim::game::player_action>& local_actions =
+      m_unconfirmed_actions[m_local_player_index];
+
+  if (tick_count > local_actions.size())
+    return false;
+
+  const std::array<std::size_t, bim::game::g_max_player_count> kick_tick =
+      bim::game::find_kick_event_tick(m_server_actions, tick_count);
+
+  for (int player_index = 0; player_index != m_player_count; ++player_index)
+    {
+      // A player with fewer actions than the others has left the game, by a
+      // kick or by its death. There is nothing to predict for them. If their
+      // exit has not been simulated locally then the player is still in the
+      // predicted state, and the checksums below differ.
+      if (kick_tick[player_index] != tick_count)
+        continue;
+
+      const std::vector<bim::game::player_action>& server_actions =
+          m_server_actions[player_index];
+
+      for (std::size_t i = m_verified_tick_count; i != tick_count; ++i)
+        {
+          // Local player: the action done in tick i. Distant players: the
+          // repeated last action received from the server.
+          const bim::game::player_action& predicted =
+              (player_index == m_local_player_index)
+                  ? local_actions[i]
+                  : m_unconfirmed_actions[player_index].back();
+
+          if (server_actions[i] != predicted)
+            return false;
+        }
+    }
+
+  return m_predicted_checksums[tick_count - 1] == m_server_checksum;
+}
+
+void bim::net::contest_runner::confirm_predictions(entt::registry& registry,
+                                                   std::size_t tick_count)
+{
+  m_verified_tick_count = tick_count;
+  m_last_confirmed_checksum = m_predicted_checksums[tick_count - 1];
+
+  // If all the simulated ticks are confirmed then the current state is the
+  // confirmed state.
+  if (tick_count != m_unconfirmed_actions[m_local_player_index].size())
+    return;
+
+  m_confirmed_tick_count += tick_count;
+  m_verified_tick_count = 0;
+
+  for (int player_index = 0; player_index != m_player_count; ++player_index)
+    m_server_actions[player_index].clear();
+
+  save_contest_state(registry);
+  drop_confirmed_actions();
+}
+
 void bim::net::contest_runner::restore_last_confirmed_state(
     entt::registry& registry)
 {
-  bim::game::deserialize_state(registry, m_last_confirmed_archive);
+  m_last_confirmed_state.restore(registry);
   m_contest.entity_map(m_last_confirmed_entity_map);
 }
 
@@ -223,6 +301,7 @@ void bim::net::contest_runner::apply_server_actions(entt::registry& registry)
       }
 
   m_confirmed_tick_count += tick_count;
+  m_verified_tick_count = 0;
   assert(m_confirmed_tick_count <= m_completed_tick_count);
 
   for (int player_index = 0; player_index != m_player_count; ++player_index)
@@ -231,8 +310,8 @@ void bim::net::contest_runner::apply_server_actions(entt::registry& registry)
 
 void bim::net::contest_runner::save_contest_state(entt::registry& registry)
 {
-  bim::game::serialize_state(m_last_confirmed_archive, registry);
-  m_last_confirmed_checksum = bim::game::game_state_checksum(registry);
+  m_last_confirmed_state.save(registry);
+  m_last_confirmed_checksum = m_contest.state_checksum();
 
   m_last_confirmed_entity_map = m_contest.entity_map();
 }
@@ -247,10 +326,16 @@ void bim::net::contest_runner::drop_confirmed_actions()
 
   bim_assume(keep_count <= actions.size());
   actions.erase(actions.begin(), actions.end() - keep_count);
+
+  bim_assume(keep_count <= m_predicted_checksums.size());
+  m_predicted_checksums.erase(m_predicted_checksums.begin(),
+                              m_predicted_checksums.end() - keep_count);
 }
 
 void bim::net::contest_runner::apply_unconfirmed_actions()
 {
+  m_predicted_checksums.clear();
+
   for (std::size_t i = 0,
                    n = m_unconfirmed_actions[m_local_player_index].size();
        i != n; ++i)
@@ -275,6 +360,7 @@ void bim::net::contest_runner::apply_unconfirmed_actions()
         }
 
       m_contest.tick();
+      m_predicted_checksums.push_back(m_contest.state_checksum());
     }
 }
 
@@ -172,7 +172,7 @@ bool bim::net::game_update_exchange::validate_message(
       return false;
     }
 
-  if (message.actions.size() != m_player_count)
+  if (message.player_count != m_player_count)
     return false;
 
   bim_assume(m_player_count >= 2);
@@ -209,7 +209,7 @@ void bim::net::game_update_exchange::store_server_frames(
 
   for (int player_index = 0; player_index != m_player_count; ++player_index)
     {
-      const std::vector<bim::game::player_action>& server_actions =
+      const game_update_from_server::action_list& server_actions =
           message.actions[player_index];
       std::vector<bim::game::player_action>& local_actions =
           m_server_update.actions[player_index];
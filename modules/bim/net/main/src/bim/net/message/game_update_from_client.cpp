@@ -19,8 +19,7 @@ bim::net::game_update_from_client::game_update_from_client(
 
   iscool::net::byte_array_bit_reader bits(reader);
 
-  for (bim::game::player_action& action : actions)
-    read(action, bits);
+  read_runs(actions, bits);
 }
 
 void bim::net::game_update_from_client::build_message(
@@ -34,8 +33,7 @@ void bim::net::game_update_from_client::build_message(
 
   iscool::net::byte_array_bit_inserter bits(content);
 
-  for (const bim::game::player_action& action : actions)
-    write(bits, action);
+  write_runs(bits, actions);
 
   bits.flush();
 }
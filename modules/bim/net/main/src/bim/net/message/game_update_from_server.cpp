@@ -6,29 +6,33 @@
 #include <iscool/net/byte_array_bit_inserter.hpp>
 #include <iscool/net/byte_array_bit_reader.hpp>
 
-bim::net::game_update_from_server::game_update_from_server() = default;
+#include <stdexcept>
+
+bim::net::game_update_from_server::game_update_from_server()
+  : player_count(0)
+{}
 
 bim::net::game_update_from_server::game_update_from_server(
     const iscool::net::byte_array& raw_content)
 {
   iscool::net::byte_array_reader reader(raw_content);
-  std::uint8_t player_count;
 
   reader >> from_tick >> final_checksum >> player_count;
-  actions.resize(player_count);
 
-  for (std::vector<bim::game::player_action>& v : actions)
+  if (player_count > actions.size())
+    throw std::runtime_error("Too many players.");
+
+  for (std::uint8_t i = 0; i != player_count; ++i)
     {
       std::uint8_t size;
       reader >> size;
-      v.resize(size);
+      actions[i].resize(size);
     }
 
   iscool::net::byte_array_bit_reader bits(reader);
 
-  for (std::vector<bim::game::player_action>& v : actions)
-    for (bim::game::player_action& action : v)
-      read(action, bits);
+  for (std::uint8_t i = 0; i != player_count; ++i)
+    read_runs({ actions[i].data(), actions[i].size() }, bits);
 }
 
 void bim::net::game_update_from_server::build_message(
@@ -38,22 +42,21 @@ void bim::net::game_update_from_server::build_message(
 
   iscool::net::byte_array& content = message.get_content();
 
-  const std::uint8_t player_count = actions.size();
   assert(player_count > 0);
+  assert(player_count <= actions.size());
 
   content << from_tick << final_checksum << player_count;
 
-  for (const std::vector<bim::game::player_action>& v : actions)
+  for (std::uint8_t i = 0; i != player_count; ++i)
     {
-      const std::uint8_t size = v.size();
+      const std::uint8_t size = actions[i].size();
       content << size;
     }
 
   iscool::net::byte_array_bit_inserter bits(content);
 
-  for (const std::vector<bim::game::player_action>& v : actions)
-    for (const bim::game::player_action& action : v)
-      write(bits, action);
+  for (std::uint8_t i = 0; i != player_count; ++i)
+    write_runs(bits, { actions[i].data(), actions[i].size() });
 
   bits.flush();
 }
@@ -7,11 +7,74 @@
 #include <iscool/net/byte_array_bit_inserter.hpp>
 #include <iscool/net/byte_array_bit_reader.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
 static constexpr int g_bits_in_movement = 3;
 
+// The length of a run is encoded as a single zero bit for runs of a single
+// action, otherwise as a one bit followed by the length minus two, by groups
+// of g_bits_in_run_digit bits, each group followed by a bit telling if
+// another group follows.
+static constexpr int g_bits_in_run_digit = 3;
+static constexpr std::size_t g_run_digit_mask = (1 << g_bits_in_run_digit) - 1;
+
+// Enough digits to encode the length of any sequence of actions in the
+// messages.
+static constexpr int g_max_run_digits = 3;
+
+static std::size_t read_run_length(iscool::net::byte_array_bit_reader& bits)
+{
+  const bool long_run = bits.get(1);
+
+  if (!long_run)
+    return 1;
+
+  std::size_t result = 0;
+
+  for (int i = 0; i != g_max_run_digits; ++i)
+    {
+      const std::uint8_t digit = bits.get(g_bits_in_run_digit);
+      result |= (std::size_t)digit << (i * g_bits_in_run_digit);
+
+      const bool more = bits.get(1);
+
+      if (!more)
+        return result + 2;
+    }
+
+  throw std::runtime_error("");
+}
+
+static void write_run_length(iscool::net::byte_array_bit_inserter& bits,
+                             std::size_t length)
+{
+  assert(length >= 1);
+
+  if (length == 1)
+    {
+      bits.append(0, 1);
+      return;
+    }
+
+  bits.append(1, 1);
+
+  std::size_t remainder = length - 2;
+
+  while (true)
+    {
+      bits.append(remainder & g_run_digit_mask, g_bits_in_run_digit);
+      remainder >>= g_bits_in_run_digit;
+
+      const bool more = remainder != 0;
+      bits.append(more, 1);
+
+      if (!more)
+        break;
+    }
+}
+
 void bim::net::read(bim::game::player_action& action,
                     iscool::net::byte_array_bit_reader& bits)
 {
@@ -31,3 +94,38 @@ void bim::net::write(iscool::net::byte_array_bit_inserter& bits,
   bits.append(action.movement, 3);
   bits.append(action.drop_bomb, 1);
 }
+
+void bim::net::read_runs(std::span<bim::game::player_action> actions,
+                         iscool::net::byte_array_bit_reader& bits)
+{
+  for (std::size_t i = 0, n = actions.size(); i != n;)
+    {
+      bim::game::player_action action;
+      read(action, bits);
+
+      const std::size_t length = read_run_length(bits);
+
+      if (length > n - i)
+        throw std::runtime_error("");
+
+      std::fill_n(actions.begin() + i, length, action);
+      i += length;
+    }
+}
+
+void bim::net::write_runs(iscool::net::byte_array_bit_inserter& bits,
+                          std::span<const bim::game::player_action> actions)
+{
+  for (std::size_t i = 0, n = actions.size(); i != n;)
+    {
+      const bim::game::player_action& action = actions[i];
+      std::size_t length = 1;
+
+      while ((i + length != n) && (actions[i + length] == action))
+        ++length;
+
+      write(bits, action);
+      write_run_length(bits, length);
+      i += length;
+    }
+}
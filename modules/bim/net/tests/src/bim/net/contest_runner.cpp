@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/net/contest_runner.hpp>
+
+#include <bim/net/exchange/game_update_exchange.hpp>
+#include <bim/net/exchange/server_update.hpp>
+
+#include <bim/game/component/player.hpp>
+#include <bim/game/component/player_action.hpp>
+#include <bim/game/component/player_movement.hpp>
+#include <bim/game/constant/default_arena_size.hpp>
+#include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/kick_event.hpp>
+#include <bim/game/player_action.hpp>
+
+#include <iscool/net/message_channel.hpp>
+#include <iscool/net/message_stream.hpp>
+#include <iscool/net/socket_stream.hpp>
+#include <iscool/schedule/manual_scheduler.hpp>
+#include <iscool/schedule/setup.hpp>
+#include <iscool/time/setup.hpp>
+
+#include <entt/entity/registry.hpp>
+
+#include <gtest/gtest.h>
+
+/**
+ * The client runs its contest through a contest_runner, and the updates from
+ * the server are built from a reference contest, then passed directly to
+ * contest_runner::queue_updates(). The exchange is never started, thus
+ * nothing is received from the socket.
+ */
+class bim_net_contest_runner_test : public ::testing::Test
+{
+public:
+  bim_net_contest_runner_test();
+
+protected:
+  static constexpr std::uint8_t player_count = 2;
+  static constexpr std::uint8_t local_player_index = 0;
+
+  static constexpr bim::game::player_action move_right = {
+    .movement = bim::game::player_movement::right, .drop_bomb = false
+  };
+  static constexpr bim::game::player_action move_down = {
+    .movement = bim::game::player_movement::down, .drop_bomb = false
+  };
+
+protected:
+  void run_client(std::size_t tick_count,
+                  const bim::game::player_action& action);
+
+  std::uint32_t tick_reference(std::size_t tick_count,
+                               const bim::game::player_action& local_action,
+                               const bim::game::player_action& remote_action);
+
+  void queue_updates(std::uint32_t from_tick, std::size_t tick_count,
+                     const bim::game::player_action& local_action,
+                     const bim::game::player_action& remote_action,
+                     std::uint32_t checksum);
+
+private:
+  static bim::game::contest_fingerprint fingerprint();
+
+private:
+  iscool::time::scoped_time_source_delegate m_time_source_initializer;
+  iscool::schedule::manual_scheduler m_scheduler;
+  iscool::schedule::scoped_scheduler_delegate m_scheduler_initializer;
+
+  iscool::net::socket_stream m_socket_stream;
+  iscool::net::message_stream m_message_stream;
+  iscool::net::message_channel m_message_channel;
+  bim::net::game_update_exchange m_update_exchange;
+
+protected:
+  bim::game::contest m_contest;
+  bim::game::contest m_reference;
+  bim::net::contest_runner m_runner;
+};
+
+bim_net_contest_runner_test::bim_net_contest_runner_test()
+  : m_time_source_initializer(
+        []() -> std::chrono::nanoseconds
+          {
+            return {};
+          },
+        []() -> std::chrono::nanoseconds
+          {
+            return {};
+          })
+  , m_scheduler_initializer(m_scheduler.get_delayed_call_delegate())
+  , m_socket_stream("localhost:23899", iscool::net::socket_mode::client{})
+  , m_message_stream(m_socket_stream)
+  , m_message_channel(m_message_stream, 1, 1)
+  , m_update_exchange(m_message_channel, player_count)
+  , m_contest(fingerprint())
+  , m_reference(fingerprint())
+  , m_runner(m_contest, m_update_exchange, local_player_index, player_count)
+{}
+
+bim::game::contest_fingerprint bim_net_contest_runner_test::fingerprint()
+{
+  return bim::game::contest_fingerprint{
+    .seed = 1234,
+    .features = {},
+    .player_count = player_count,
+    .crate_probability = 0,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
+}
+
+void bim_net_contest_runner_test::run_client(
+    std::size_t tick_count, const bim::game::player_action& action)
+{
+  bim::game::player_action* const local_action =
+      bim::game::find_player_action_by_index(m_contest.registry(),
+                                             local_player_index);
+  ASSERT_NE(nullptr, local_action);
+
+  *local_action = action;
+  m_runner.run(tick_count * bim::game::contest::tick_interval);
+}
+
+std::uint32_t bim_net_contest_runner_test::tick_reference(
+    std::size_t tick_count, const bim::game::player_action& local_action,
+    const bim::game::player_action& remote_action)
+{
+  for (std::size_t i = 0; i != tick_count; ++i)
+    {
+      entt::registry& registry = m_reference.registry();
+
+      if (bim::game::player_action* const action =
+              bim::game::find_player_action_by_index(registry,
+                                                     local_player_index))
+        *action = local_action;
+
+      if (bim::game::player_action* const action =
+              bim::game::find_player_action_by_index(registry, 1))
+        *action = remote_action;
+
+      m_reference.tick();
+    }
+
+  return m_reference.state_checksum();
+}
+
+void bim_net_contest_runner_test::queue_updates(
+    std::uint32_t from_tick, std::size_t tick_count,
+    const bim::game::player_action& local_action,
+    const bim::game::player_action& remote_action, std::uint32_t checksum)
+{
+  bim::net::server_update update;
+  update.from_tick = from_tick;
+  update.final_checksum = checksum;
+  update.actions[local_player_index].assign(tick_count, local_action);
+  update.actions[1].assign(tick_count, remote_action);
+
+  m_runner.queue_updates(update);
+}
+
+TEST_F(bim_net_contest_runner_test, predictions_match)
+{
+  run_client(3, move_right);
+
+  const std::uint32_t checksum = tick_reference(2, move_right, {});
+  queue_updates(0, 2, move_right, {}, checksum);
+  m_runner.run({});
+
+  // The server confirmed the first two ticks, there is nothing to restore.
+  EXPECT_EQ(0, m_runner.rollback_count());
+  EXPECT_EQ(2, m_runner.confirmed_tick());
+  EXPECT_EQ(3, m_runner.local_tick());
+  EXPECT_EQ(tick_reference(1, move_right, {}), m_contest.state_checksum());
+
+  // Confirming the last tick too.
+  queue_updates(2, 1, move_right, {}, m_reference.state_checksum());
+  m_runner.run({});
+
+  EXPECT_EQ(0, m_runner.rollback_count());
+  EXPECT_EQ(3, m_runner.confirmed_tick());
+  EXPECT_EQ(m_reference.state_checksum(), m_contest.state_checksum());
+
+  // The confirmed state has been saved: the next rollback starts from here.
+  run_client(2, move_right);
+
+  const std::uint32_t down_checksum = tick_reference(1, move_right, move_down);
+  queue_updates(3, 1, move_right, move_down, down_checksum);
+  m_runner.run({});
+
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(4, m_runner.confirmed_tick());
+  EXPECT_EQ(tick_reference(1, move_right, move_down),
+            m_contest.state_checksum());
+}
+
+TEST_F(bim_net_contest_runner_test, mispredicted_remote_action)
+{
+  run_client(3, move_right);
+
+  // The client predicted that the remote player stays idle, but it moved.
+  const std::uint32_t checksum = tick_reference(2, move_right, move_down);
+  queue_updates(0, 2, move_right, move_down, checksum);
+  m_runner.run({});
+
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(2, m_runner.confirmed_tick());
+  EXPECT_EQ(3, m_runner.local_tick());
+
+  // The last tick has been replayed with the last action of the remote
+  // player.
+  EXPECT_EQ(tick_reference(1, move_right, move_down),
+            m_contest.state_checksum());
+}
+
+TEST_F(bim_net_contest_runner_test, checksum_mismatch)
+{
+  // Diverge from the server without changing the actions.
+  for (auto&& [entity, player] :
+       m_contest.registry().view<bim::game::player>().each())
+    if (player.index == 1)
+      ++player.bomb_strength;
+
+  run_client(3, move_right);
+
+  const std::uint32_t checksum = tick_reference(2, move_right, {});
+  queue_updates(0, 2, move_right, {}, checksum);
+  m_runner.run({});
+
+  // The actions are the predicted ones but the state is not, so the runner
+  // had to go back to the confirmed state.
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(2, m_runner.confirmed_tick());
+  EXPECT_EQ(tick_reference(1, move_right, {}), m_contest.state_checksum());
+}
+
+TEST_F(bim_net_contest_runner_test, max_verified_tick_count)
+{
+  // Less than a second of ticks, then more than a second.
+  constexpr std::size_t first_tick_count = 30;
+  constexpr std::size_t second_tick_count = 25;
+  constexpr std::size_t local_tick_count = 60;
+
+  run_client(local_tick_count, move_right);
+
+  queue_updates(0, first_tick_count, move_right, {},
+                tick_reference(first_tick_count, move_right, {}));
+  m_runner.run({});
+
+  EXPECT_EQ(0, m_runner.rollback_count());
+  EXPECT_EQ(first_tick_count, m_runner.confirmed_tick());
+
+  // The predictions still match but there are too many verified ticks since
+  // the saved state, so it is rebuilt.
+  queue_updates(first_tick_count, second_tick_count, move_right, {},
+                tick_reference(second_tick_count, move_right, {}));
+  m_runner.run({});
+
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(first_tick_count + second_tick_count, m_runner.confirmed_tick());
+  EXPECT_EQ(local_tick_count, m_runner.local_tick());
+  EXPECT_EQ(tick_reference(local_tick_count - first_tick_count
+                               - second_tick_count,
+                           move_right, {}),
+            m_contest.state_checksum());
+}
+
+TEST_F(bim_net_contest_runner_test, kicked_player)
+{
+  run_client(4, move_right);
+
+  // The remote player is kicked at the first tick, thus there is no action
+  // for them in the updates.
+  bim::game::kick_player(m_reference.registry(), 1);
+
+  bim::net::server_update update;
+  update.from_tick = 0;
+  update.final_checksum = tick_reference(2, move_right, {});
+  update.actions[local_player_index].assign(2, move_right);
+
+  m_runner.queue_updates(update);
+  m_runner.run({});
+
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(2, m_runner.confirmed_tick());
+
+  // The kick has been simulated. The next updates do not have actions for
+  // this player either, but they match the predictions.
+  update.from_tick = 2;
+  update.final_checksum = tick_reference(2, move_right, {});
+
+  m_runner.queue_updates(update);
+  m_runner.run({});
+
+  EXPECT_EQ(1, m_runner.rollback_count());
+  EXPECT_EQ(4, m_runner.confirmed_tick());
+  EXPECT_EQ(m_reference.state_checksum(), m_contest.state_checksum());
+}
@@ -2,9 +2,55 @@
 #include <bim/net/message/game_update_from_server.hpp>
 
 #include <bim/game/component/player_movement.hpp>
+#include <bim/game/constant/max_player_count.hpp>
 
 #include <gtest/gtest.h>
 
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+// Count the allocations, for the test about the allocation-free
+// serialization.
+static std::size_t g_allocation_count = 0;
+
+void* operator new(std::size_t count)
+{
+  ++g_allocation_count;
+
+  void* const r = std::malloc((count == 0) ? 1 : count);
+
+  if (!r)
+    throw std::bad_alloc();
+
+  return r;
+}
+
+void* operator new[](std::size_t count)
+{
+  return operator new(count);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
 TEST(bim_net_game_update_from_server, serialization)
 {
   bim::net::game_update_from_server source;
@@ -15,7 +61,7 @@ TEST(bim_net_game_update_from_server, serialization)
   source.from_tick = 24;
   source.final_checksum = 42;
 
-  source.actions.resize(4);
+  source.player_count = 4;
 
   source.actions[0].push_back({ bim::game::player_movement::idle, false });
   source.actions[0].push_back({ bim::game::player_movement::left, false });
@@ -42,7 +88,7 @@ TEST(bim_net_game_update_from_server, serialization)
   EXPECT_EQ(24, deserialized.from_tick);
   EXPECT_EQ(42, deserialized.final_checksum);
 
-  ASSERT_EQ(4, deserialized.actions.size());
+  ASSERT_EQ(4, deserialized.player_count);
 
   ASSERT_EQ(3, deserialized.actions[0].size());
   EXPECT_EQ(bim::game::player_movement::idle,
@@ -96,3 +142,42 @@ TEST(bim_net_game_update_from_server, serialization)
             deserialized.actions[3][2].movement);
   EXPECT_TRUE(deserialized.actions[3][2].drop_bomb);
 }
+
+TEST(bim_net_game_update_from_server, too_many_players)
+{
+  iscool::net::byte_array content;
+  content << std::uint32_t(24) << std::uint32_t(42)
+          << std::uint8_t(bim::game::g_max_player_count + 1);
+
+  EXPECT_THROW(bim::net::game_update_from_server{ content },
+               std::runtime_error);
+}
+
+TEST(bim_net_game_update_from_server, no_allocation)
+{
+  iscool::net::message message;
+
+  const auto build = [&message]() -> void
+  {
+    bim::net::game_update_from_server update;
+    update.from_tick = 24;
+    update.final_checksum = 42;
+    update.player_count = 4;
+
+    for (std::uint8_t i = 0; i != update.player_count; ++i)
+      update.actions[i].resize(
+          bim::net::game_update_from_server::max_action_count,
+          { bim::game::player_movement::left, true });
+
+    update.build_message(message);
+  };
+
+  // The first call reserves the memory in the message.
+  build();
+
+  // Then reusing the message, as done with the message pools, must not
+  // allocate anything.
+  const std::size_t allocation_count = g_allocation_count;
+  build();
+  EXPECT_EQ(allocation_count, g_allocation_count);
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: AGPL-3.0-only
+#include <bim/net/message/player_action_serialization.hpp>
+
+#include <bim/game/component/player_action.hpp>
+#include <bim/game/component/player_movement.hpp>
+
+#include <iscool/net/byte_array.hpp>
+#include <iscool/net/byte_array_bit_inserter.hpp>
+#include <iscool/net/byte_array_bit_reader.hpp>
+#include <iscool/net/byte_array_reader.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+static std::vector<bim::game::player_action>
+round_trip(const std::vector<bim::game::player_action>& actions,
+           std::size_t& byte_count)
+{
+  iscool::net::byte_array content;
+
+  {
+    iscool::net::byte_array_bit_inserter bits(content);
+    bim::net::write_runs(bits, actions);
+    bits.flush();
+  }
+
+  byte_count = content.size();
+
+  std::vector<bim::game::player_action> result(actions.size());
+  iscool::net::byte_array_reader reader(content);
+  iscool::net::byte_array_bit_reader bits(reader);
+  bim::net::read_runs(result, bits);
+
+  return result;
+}
+
+TEST(bim_net_player_action_serialization, runs)
+{
+  std::vector<bim::game::player_action> actions;
+  std::size_t byte_count;
+
+  EXPECT_EQ(actions, round_trip(actions, byte_count));
+
+  // Single actions.
+  actions.push_back({ bim::game::player_movement::idle, false });
+  actions.push_back({ bim::game::player_movement::left, false });
+  actions.push_back({ bim::game::player_movement::left, true });
+  actions.push_back({ bim::game::player_movement::up, false });
+  EXPECT_EQ(actions, round_trip(actions, byte_count));
+
+  // Runs of various lengths, around the boundaries of the digits of the
+  // encoded lengths.
+  for (int length : { 2, 9, 10, 65, 66 })
+    actions.insert(actions.end(), length,
+                   { bim::game::player_movement::right, (length % 2) == 0 });
+
+  EXPECT_EQ(actions, round_trip(actions, byte_count));
+}
+
+TEST(bim_net_player_action_serialization, long_run)
+{
+  const std::vector<bim::game::player_action> actions(
+      255, { bim::game::player_movement::down, false });
+  std::size_t byte_count;
+
+  EXPECT_EQ(actions, round_trip(actions, byte_count));
+
+  // One action and a length encoded in 13 bits.
+  EXPECT_EQ(3, byte_count);
+}
+
+TEST(bim_net_player_action_serialization, run_too_long)
+{
+  const std::vector<bim::game::player_action> actions(
+      10, { bim::game::player_movement::down, false });
+
+  iscool::net::byte_array content;
+
+  {
+    iscool::net::byte_array_bit_inserter bits(content);
+    bim::net::write_runs(bits, actions);
+    bits.flush();
+  }
+
+  std::vector<bim::game::player_action> result(5);
+  iscool::net::byte_array_reader reader(content);
+  iscool::net::byte_array_bit_reader bits(reader);
+
+  EXPECT_THROW(bim::net::read_runs(result, bits), std::runtime_error);
+}
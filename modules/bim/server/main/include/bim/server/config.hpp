@@ -135,6 +135,26 @@ namespace bim::server
      */
     bool game_service_enable_checksum_validation;
 
+    /**
+     * How many worker threads run the game simulations. The games are
+     * partitioned by channel among the threads. Zero means that the games are
+     * simulated in the thread processing the messages.
+     */
+    std::uint16_t game_service_shard_count;
+
+    /**
+     * Whether or not we measure the execution time of the systems of the
+     * games. The measures are aggregated in the statistics.
+     */
+    bool game_service_enable_system_timings;
+
+    /**
+     * How many cells the bots can analyze per tick when looking for a new
+     * goal. This bounds the cost of the bots in the simulation. Zero means no
+     * limit.
+     */
+    std::uint16_t game_service_bot_think_budget;
+
     /** Path to the folder where to store the contest timelines. */
     std::string contest_timeline_folder;
 
@@ -190,6 +210,12 @@ namespace bim::server
      */
     std::chrono::seconds business_registration_pulse_seconds;
 
+    /**
+     * How many HTTP requests, to the business server or to Discord, can be
+     * processed concurrently.
+     */
+    std::uint16_t http_max_connections;
+
     /** The name of the server, as sent to the clients. */
     std::string name;
 
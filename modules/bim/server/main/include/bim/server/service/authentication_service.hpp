@@ -4,6 +4,8 @@
 #include <bim/net/message/client_token.hpp>
 #include <bim/net/message/hello_ok.hpp>
 
+#include <bim/deadline_queue.hpp>
+
 #include <iscool/net/message_pool.hpp>
 #include <iscool/net/message_stream.hpp>
 #include <iscool/schedule/scoped_connection.hpp>
@@ -83,6 +85,10 @@ namespace bim::server
     iscool::signals::scoped_connection m_session_connection;
     pending_authentication_map m_pending_authentication;
 
+    /// The tokens of m_pending_authentication, by release date.
+    bim::deadline_queue<bim::net::client_token>
+        m_pending_authentication_expiry;
+
     bim::net::hello_ok m_hello_ok;
 
     iscool::schedule::scoped_connection m_clean_up_connection;
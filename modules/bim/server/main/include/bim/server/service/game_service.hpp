@@ -8,15 +8,17 @@
 #include <bim/game/feature_flags_fwd.hpp>
 #include <bim/game/per_player_array.hpp>
 
-#include <iscool/net/message_pool.hpp>
 #include <iscool/net/message_stream.hpp>
 
 #include <iscool/schedule/scoped_connection.hpp>
 
 #include <boost/unordered/unordered_map.hpp>
 
+#include <atomic>
+#include <memory>
 #include <optional>
 #include <random>
+#include <vector>
 
 namespace bim::net
 {
@@ -54,53 +56,100 @@ namespace bim::server
 
   private:
     struct game;
+    struct game_summary;
+    struct shard;
+    struct shard_command;
+    struct shard_event;
+    struct shard_thread;
+
     using game_map = boost::unordered_map<iscool::net::channel_id, game>;
+    using game_summary_map =
+        boost::unordered_map<iscool::net::channel_id, game_summary>;
     using session_to_channel_map =
         boost::unordered_map<iscool::net::session_id, iscool::net::channel_id>;
 
   private:
-    void mark_as_ready(const iscool::net::endpoint& endpoint,
+    shard& channel_shard(iscool::net::channel_id channel);
+
+    void post(shard& s, const shard_command& command);
+    void run_shard(shard& s);
+    void execute(shard& s, const shard_command& command);
+
+    void create_game(shard& s, const shard_command& command);
+    void process(shard& s, const iscool::net::endpoint& endpoint,
+                 const iscool::net::message& message,
+                 std::chrono::nanoseconds now);
+
+    void send(shard& s, const iscool::net::endpoint& endpoint,
+              const iscool::net::message& message,
+              iscool::net::session_id session,
+              iscool::net::channel_id channel);
+    void emit(shard& s, const shard_event& event);
+
+    void signal_events();
+    void dispatch_events();
+    void dispatch(const shard_event& event);
+
+    void mark_as_ready(shard& s, const iscool::net::endpoint& endpoint,
                        iscool::net::session_id session,
                        iscool::net::channel_id channel, game& game,
                        std::chrono::nanoseconds now);
-    void push_update(const iscool::net::endpoint& endpoint,
+    void push_update(shard& s, const iscool::net::endpoint& endpoint,
                      iscool::net::channel_id channel,
                      const iscool::net::message& message, game& game,
                      std::chrono::nanoseconds now);
 
+    void schedule_update_games();
+    void update_games(shard& s);
+    void update_game(shard& s, iscool::net::channel_id channel, game& game,
+                     std::chrono::nanoseconds now);
+
     std::optional<std::size_t>
     validate_message(const bim::net::game_update_from_client& message,
                      iscool::net::session_id session, std::size_t player_index,
                      const game& game) const;
     void queue_actions(const bim::net::game_update_from_client& message,
                        std::size_t player_index, game& game);
-    void send_actions(const iscool::net::endpoint& endpoint,
-                      iscool::net::session_id session,
-                      iscool::net::channel_id channel,
-                      std::size_t player_index, const game& game);
-    void record_game_over(iscool::net::channel_id channel, game& game) const;
-    void send_game_over(const iscool::net::endpoint& endpoint,
+    void build_actions_message(iscool::net::message& result,
+                               std::uint32_t completed_tick_count_for_player,
+                               const game& game) const;
+    void record_game_over(shard& s, iscool::net::channel_id channel,
+                          game& game);
+    void send_game_over(shard& s, const iscool::net::endpoint& endpoint,
                         iscool::net::session_id session,
                         iscool::net::channel_id channel, const game& game);
 
-    void check_drop_desynchronized_player(iscool::net::channel_id channel,
+    void check_drop_desynchronized_player(shard& s,
+                                          iscool::net::channel_id channel,
                                           game& game,
-                                          std::chrono::nanoseconds now) const;
+                                          std::chrono::nanoseconds now);
+    void disconnect_player(shard& s, game& game, int player_index);
 
     void schedule_clean_up();
     void clean_up();
-    void clean_up(iscool::net::channel_id channel, const game& g);
+    void clean_up(shard& s, std::chrono::nanoseconds now);
+    void collect_system_timings();
+    void release_game(iscool::net::channel_id channel);
 
   private:
     iscool::net::message_stream m_message_stream;
     iscool::net::channel_id m_next_game_channel;
-    game_map m_games;
+    game_summary_map m_games;
     session_to_channel_map m_session_to_channel;
     std::mt19937_64 m_random;
 
     iscool::schedule::scoped_connection m_clean_up_connection;
     const std::chrono::seconds m_clean_up_interval;
 
+    /**
+     * Set by the shards when they schedule a call to dispatch_events(), such
+     * that a single call is pending at once. The call from the shards is not
+     * cancellable so it checks that the service still exists via this
+     * pointer.
+     */
+    std::shared_ptr<std::atomic<bool>> m_dispatch_scheduled;
+    iscool::schedule::scoped_connection m_update_games_connection;
+
     std::unique_ptr<contest_timeline_service> m_contest_timeline_service;
     session_service& m_session_service;
     statistics_service& m_statistics;
@@ -120,7 +169,14 @@ namespace bim::server
     const std::uint16_t m_coins_per_short_game_draw;
 
     const bool m_checksum_validation;
-
-    iscool::net::message_pool m_message_pool;
+    const bool m_system_timings;
+    const std::uint16_t m_bot_think_budget;
+
+    /**
+     * The games are partitioned among the shards by channel. When the service
+     * is not threaded there is a single shard, processed in the caller's
+     * thread.
+     */
+    std::vector<std::unique_ptr<shard>> m_shards;
   };
 }
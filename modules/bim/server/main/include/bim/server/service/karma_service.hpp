@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: AGPL-3.0-only
 #pragma once
 
+#include <bim/deadline_queue.hpp>
+
 #include <iscool/schedule/scoped_connection.hpp>
 
 #include <boost/asio/ip/address.hpp>
@@ -8,6 +10,7 @@
 
 #include <chrono>
 #include <cstdint>
+#include <vector>
 
 namespace bim::server
 {
@@ -52,6 +55,12 @@ namespace bim::server
   private:
     client_map m_client;
 
+    /// The clients whose session count dropped to zero since the last review.
+    std::vector<boost::asio::ip::address> m_idle_clients;
+
+    /// The blacklisted clients, by the date at which they are let go.
+    bim::deadline_queue<boost::asio::ip::address> m_blacklist_expiry;
+
     const std::chrono::minutes m_blacklist_time_out;
     const bool m_enabled;
     const std::int8_t m_initial_karma;
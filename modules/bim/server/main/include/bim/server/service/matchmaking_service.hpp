@@ -9,6 +9,8 @@
 
 #include <bim/game/feature_flags_fwd.hpp>
 
+#include <bim/deadline_queue.hpp>
+
 #include <iscool/net/message_pool.hpp>
 #include <iscool/net/message_stream.hpp>
 #include <iscool/schedule/scoped_connection.hpp>
@@ -120,6 +122,12 @@ namespace bim::server
     const game_reward_availability m_reward_availability;
 
     encounter_map m_encounters;
+
+    /**
+     * The encounters of m_encounters, by the earliest release date of their
+     * sessions.
+     */
+    bim::deadline_queue<bim::net::encounter_id> m_encounter_expiry;
     bim::net::encounter_id m_next_encounter_id;
 
     const bool m_enable_bots;
@@ -9,6 +9,8 @@
 
 #include <bim/business/request_headers.hpp>
 
+#include <bim/deadline_queue.hpp>
+
 #include <bim/net/message/client_token.hpp>
 #include <bim/net/message/session_token.hpp>
 #include <bim/net/message/user_id.hpp>
@@ -92,6 +94,9 @@ namespace bim::server
     id_to_session_map m_id_to_session;
     client_map m_clients;
 
+    /// The sessions of m_clients, by release date.
+    bim::deadline_queue<iscool::net::session_id> m_client_expiry;
+
     iscool::schedule::scoped_connection m_clean_up_connection;
     const std::chrono::seconds m_clean_up_interval;
     const std::chrono::seconds m_session_removal_delay;
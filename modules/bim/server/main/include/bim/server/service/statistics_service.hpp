@@ -4,6 +4,8 @@
 #include <bim/server/config.hpp>
 #include <bim/server/rolling_statistics.hpp>
 
+#include <bim/game/system_timings.hpp>
+
 #include <iscool/schedule/scoped_connection.hpp>
 
 #include <cstdint>
@@ -39,6 +41,10 @@ namespace bim::server
     void record_game_start(std::uint8_t player_count);
     void record_game_end(std::uint8_t player_count);
 
+    /// Total execution time of the systems in the games since the start.
+    const bim::game::system_timings& game_system_timings() const;
+    void record_game_system_timings(const bim::game::system_timings& timings);
+
   private:
     struct rolling_measure
     {
@@ -70,6 +76,8 @@ namespace bim::server
     std::uint32_t m_players_in_games_instant;
     std::uint32_t m_games_instant;
 
+    bim::game::system_timings m_game_system_timings;
+
     bool m_enable_file_dump;
     bool m_enable_rolling_statistics;
 
@@ -25,6 +25,9 @@ bim::server::config::config()
   , game_service_coins_per_short_game_defeat(0)
   , game_service_coins_per_short_game_draw(0)
   , game_service_enable_checksum_validation(true)
+  , game_service_shard_count(0)
+  , game_service_enable_system_timings(false)
+  , game_service_bot_think_budget(0)
   , enable_contest_timeline_recording(false)
   , geolocation_clean_up_interval(std::chrono::days(7))
   , geolocation_update_interval(std::chrono::days(7))
@@ -33,6 +36,7 @@ bim::server::config::config()
   , enable_rolling_statistics(false)
   , statistics_dump_delay(std::chrono::seconds(60))
   , business_registration_pulse_seconds(30)
+  , http_max_connections(4)
   , enable_discord_matchmaking_notifications(false)
   , discord_matchmaking_notification_interval(std::chrono::seconds(60))
   , enable_karma(false)
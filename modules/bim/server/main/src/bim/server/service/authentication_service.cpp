@@ -15,6 +15,7 @@
 #include <bim/net/message/protocol_version.hpp>
 #include <bim/net/message/try_deserialize_message.hpp>
 
+#include <bim/deadline_queue.impl.hpp>
 #include <bim/tracy.hpp>
 
 #include <iscool/log/log.hpp>
@@ -136,11 +137,22 @@ void bim::server::authentication_service::check_authentication(
       send_accepted(endpoint, token, r.session);
       break;
     case create_session_result_state::pending:
-      m_pending_authentication[token] = {
-        .endpoint = endpoint,
-        .release_at_this_date = iscool::time::now<std::chrono::nanoseconds>()
-                                + m_pending_authentication_removal_delay
-      };
+      {
+        const std::chrono::nanoseconds release_date =
+            iscool::time::now<std::chrono::nanoseconds>()
+            + m_pending_authentication_removal_delay;
+
+        // An existing entry is postponed in place, the queue will find its
+        // new date when the previous one is reached.
+        if (m_pending_authentication
+                .insert_or_assign(
+                    token,
+                    pending_authentication{ .endpoint = endpoint,
+                                            .release_at_this_date =
+                                                release_date })
+                .second)
+          m_pending_authentication_expiry.push(token, release_date);
+      }
     }
 }
 
@@ -292,18 +304,27 @@ void bim::server::authentication_service::clean_up()
 
   const std::size_t old_count = m_pending_authentication.size();
 
-  for (pending_authentication_map::iterator
-           it = m_pending_authentication.begin(),
-           eit = m_pending_authentication.end();
-       it != eit;)
-    if (it->second.release_at_this_date <= now)
-      {
-        ic_log(iscool::log::nature::info(), "authentication_service",
-               "Removing token={}.", it->first);
-        it = m_pending_authentication.erase(it);
-      }
-    else
-      ++it;
+  m_pending_authentication_expiry.pop_expired(
+      now,
+      [this, now](bim::net::client_token token)
+          -> std::optional<std::chrono::nanoseconds>
+        {
+          const pending_authentication_map::iterator it =
+              m_pending_authentication.find(token);
+
+          // The authentication has been completed since then.
+          if (it == m_pending_authentication.end())
+            return std::nullopt;
+
+          if (it->second.release_at_this_date > now)
+            return it->second.release_at_this_date;
+
+          ic_log(iscool::log::nature::info(), "authentication_service",
+                 "Removing token={}.", it->first);
+          m_pending_authentication.erase(it);
+
+          return std::nullopt;
+        });
 
   if (old_count != m_pending_authentication.size())
     ic_log(iscool::log::nature::info(), "authentication_service",
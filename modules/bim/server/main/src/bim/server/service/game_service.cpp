@@ -25,21 +25,36 @@
 #include <bim/game/constant/default_crate_probability.hpp>
 #include <bim/game/constant/max_player_count.hpp>
 #include <bim/game/contest.hpp>
+#include <bim/game/contest_fingerprint.hpp>
+#include <bim/game/contest_pool.hpp>
 #include <bim/game/contest_result.hpp>
-#include <bim/game/game_state_checksum.hpp>
 #include <bim/game/kick_event.hpp>
 #include <bim/game/player_action.hpp>
+#include <bim/game/system_timings.hpp>
 
 #include <bim/assume.hpp>
+#include <bim/deadline_queue.impl.hpp>
+#include <bim/ring_buffer.impl.hpp>
 
 #include <iscool/log/log.hpp>
 #include <iscool/log/nature/info.hpp>
+#include <iscool/net/message_pool.hpp>
 #include <iscool/schedule/delayed_call.hpp>
 #include <iscool/time/now.hpp>
 
+#include <boost/container/static_vector.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <functional>
 #include <limits>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
 
 namespace
 {
@@ -63,6 +78,33 @@ namespace
     /// The game was already over when the tick started.
     flushing
   };
+
+  enum class shard_command_kind : std::uint8_t
+  {
+    message,
+    new_game,
+    clean_up
+  };
+
+  enum class shard_event_kind : std::uint8_t
+  {
+    send,
+    karma_disconnection,
+    karma_short_game,
+    karma_good_behavior,
+    game_over,
+    game_released
+  };
+
+  constexpr std::size_t g_shard_command_capacity = 1024;
+  constexpr std::size_t g_shard_event_capacity = 4096;
+
+  /// An update of the actions, encoded for the players at a given tick.
+  struct encoded_actions
+  {
+    std::uint32_t from_tick;
+    iscool::net::message_pool::slot slot;
+  };
 }
 
 struct bim::server::game_service::game
@@ -126,11 +168,12 @@ struct bim::server::game_service::game
   */
 
 public:
-  game(std::uint8_t player_count, std::uint64_t seed,
+  game(std::unique_ptr<bim::game::contest> new_contest,
+       std::uint8_t player_count, std::uint64_t seed,
        bim::game::feature_flags features,
        const bim::game::per_player_array<iscool::net::session_id>& sessions,
        game_reward_availability reward_availability,
-       std::optional<std::uint8_t> bot_index)
+       std::optional<std::uint8_t> bot_index, std::uint16_t bot_think_budget)
     : seed(seed)
     , features(features)
     , player_count(player_count)
@@ -139,19 +182,17 @@ public:
     , completed_tick_count_all(0)
     , contest_result(bim::game::contest_result::create_still_running())
     , reward_availability(reward_availability)
-    , contest({ .seed = seed,
-                .features = features,
-                .player_count = player_count,
-                .crate_probability = bim::game::g_default_crate_probability,
-                .arena_width = bim::game::g_default_arena_width,
-                .arena_height = bim::game::g_default_arena_height })
+    , contest(std::move(new_contest))
+    , dirty(false)
   {
     ready.fill(false);
     active.fill(false);
     completed_tick_count_per_player.fill(0);
 
     for (int i = 0; i != player_count; ++i)
-      actions[i].reserve(32);
+      actions[i].reserve(64);
+
+    simulation_checksum.reserve(64);
 
     push_game_state_checksum();
 
@@ -160,8 +201,9 @@ public:
     if (bot_index)
       {
         bot[*bot_index] = true;
-        m_bot.reset(new bim::game::bot(*bot_index, contest.arena().width(),
-                                       contest.arena().height(), seed));
+        m_bot.reset(new bim::game::bot(*bot_index, contest->arena().width(),
+                                       contest->arena().height(), seed));
+        m_bot->think_budget(bot_think_budget);
       }
   }
 
@@ -171,8 +213,8 @@ public:
              .features = features,
              .player_count = player_count,
              .crate_probability = bim::game::g_default_crate_probability,
-             .arena_width = contest.arena().width(),
-             .arena_height = contest.arena().height() };
+             .arena_width = contest->arena().width(),
+             .arena_height = contest->arena().height() };
   }
 
   std::size_t session_index(iscool::net::session_id session) const
@@ -222,19 +264,16 @@ private:
     for (std::uint8_t player_index = 0; player_index != player_count;
          ++player_index)
       {
-        std::vector<bim::game::player_action>& player_actions =
+        bim::ring_buffer<bim::game::player_action>& player_actions =
             actions[player_index];
 
         // Inactive players may not have "offset" actions, so we must restrict
         // the removal to what we actually have.
-        player_actions.erase(
-            player_actions.begin(),
-            player_actions.begin()
-                + std::min(offset_to_all, player_actions.size()));
+        player_actions.pop_front(
+            std::min(offset_to_all, player_actions.size()));
       }
 
-    simulation_checksum.erase(simulation_checksum.begin(),
-                              simulation_checksum.begin() + offset_to_all);
+    simulation_checksum.pop_front(offset_to_all);
 
     completed_tick_count_all += offset_to_all;
     assert(completed_tick_count_all <= simulation_tick);
@@ -302,13 +341,13 @@ private:
     for (std::size_t i = 0; i != count; ++i)
       {
         bim::game::per_player_array<bim::game::player_action*> player_actions;
-        bim::game::collect_player_actions(player_actions, contest.registry());
+        bim::game::collect_player_actions(player_actions, contest->registry());
 
         for (int p = 0; p != player_count; ++p)
           if (player_actions[p])
             {
               if (!active[p])
-                bim::game::kick_player(contest.registry(), p);
+                bim::game::kick_player(contest->registry(), p);
               else
                 {
                   const std::size_t action_index = action_base_index + i;
@@ -316,7 +355,7 @@ private:
                   if (m_bot && (p == m_bot->player_index()))
                     {
                       assert(action_index == actions[p].size());
-                      actions[p].push_back(m_bot->think(contest));
+                      actions[p].push_back(m_bot->think(*contest));
                     }
 
                   assert(action_index < actions[p].size());
@@ -325,9 +364,9 @@ private:
             }
 
         if (timeline_writer)
-          timeline_writer.push(contest.registry());
+          timeline_writer.push(contest->registry());
 
-        const bim::game::contest_result tick_result = contest.tick();
+        const bim::game::contest_result tick_result = contest->tick();
         push_game_state_checksum();
 
         if (contest_result.still_running() && !tick_result.still_running())
@@ -344,9 +383,7 @@ private:
 
   void push_game_state_checksum()
   {
-    const std::uint32_t checksum =
-        bim::game::game_state_checksum(contest.registry());
-    simulation_checksum.push_back(checksum);
+    simulation_checksum.push_back(contest->state_checksum());
   }
 
 public:
@@ -381,12 +418,18 @@ public:
 
   /**
    * The actions to apply starting from completed_tick_count_all, for each
-   * player. One player_action per tick.
+   * player. One player_action per tick. The confirmed actions are removed
+   * from the front, the new ones are added at the back, so we use ring
+   * buffers to avoid moving the actions in between.
    */
-  bim::game::per_player_array<std::vector<bim::game::player_action>> actions;
+  bim::game::per_player_array<bim::ring_buffer<bim::game::player_action>>
+      actions;
 
-  /** Checksum of the game state at simulation_tick. */
-  std::vector<std::uint32_t> simulation_checksum;
+  /**
+   * Checksum of the game state at each tick, starting from
+   * completed_tick_count_all.
+   */
+  bim::ring_buffer<std::uint32_t> simulation_checksum;
 
   bim::game::per_player_array<std::chrono::nanoseconds>
       release_player_at_this_date;
@@ -400,14 +443,130 @@ public:
   std::int8_t winner_index;
   game_reward_availability reward_availability;
 
-  bim::game::contest contest;
+  std::unique_ptr<bim::game::contest> contest;
+
+  /// Filled by the contest when the system timings are enabled.
+  bim::game::system_timings system_timings;
 
   bim::game::contest_timeline_writer timeline_writer;
 
+  /**
+   * The endpoints of the players who sent an update since the last
+   * simulation step, and who are waiting for an answer.
+   */
+  bim::game::per_player_array<std::optional<iscool::net::endpoint>>
+      pending_reply;
+
+  /// Tells if the game is in the list of the games to update of its shard.
+  bool dirty;
+
 private:
   std::unique_ptr<bim::game::bot> m_bot;
 };
 
+/// What the main thread knows about a game, whatever the shard it is in.
+struct bim::server::game_service::game_summary
+{
+  bim::game::contest_fingerprint fingerprint;
+  bim::game::per_player_array<iscool::net::session_id> sessions;
+  bool playing;
+};
+
+/// A request from the main thread to a shard.
+struct bim::server::game_service::shard_command
+{
+  shard_command_kind kind;
+  std::chrono::nanoseconds now;
+  iscool::net::channel_id channel;
+
+  // shard_command_kind::message
+  iscool::net::endpoint endpoint;
+  iscool::net::message message;
+
+  // shard_command_kind::new_game
+  std::uint8_t player_count;
+  std::uint64_t seed;
+  bim::game::feature_flags features;
+  bim::game::per_player_array<iscool::net::session_id> sessions;
+  game_reward_availability reward_availability;
+  std::optional<std::uint8_t> bot_index;
+};
+
+/**
+ * A side effect of the processing of a game, that must be applied in the main
+ * thread since the sessions, the statistics, and the socket are not shared
+ * with the shards.
+ */
+struct bim::server::game_service::shard_event
+{
+  shard_event_kind kind;
+  iscool::net::channel_id channel;
+  iscool::net::session_id session;
+
+  // shard_event_kind::send
+  iscool::net::endpoint endpoint;
+  iscool::net::message message;
+};
+
+struct bim::server::game_service::shard_thread
+{
+  shard_thread()
+    : commands(g_shard_command_capacity)
+    , events(g_shard_event_capacity)
+    , pending(false)
+    , quit(false)
+  {}
+
+  /// Produced by the main thread, consumed by the shard.
+  boost::lockfree::spsc_queue<shard_command> commands;
+
+  /// Produced by the shard, consumed by the main thread.
+  boost::lockfree::spsc_queue<shard_event> events;
+
+  /// Set when commands have been pushed, to wake up the thread.
+  std::atomic<bool> pending;
+  std::atomic<bool> quit;
+
+  std::thread thread;
+};
+
+struct bim::server::game_service::shard
+{
+  shard()
+    : message_pool(64)
+    , contest_pool(16)
+    , last_message_date{}
+  {}
+
+  game_map games;
+
+  /// The channels of the games, by release date.
+  bim::deadline_queue<iscool::net::channel_id> game_expiry;
+  iscool::net::message_pool message_pool;
+
+  /// The contests of the released games, reused by the next ones.
+  bim::game::contest_pool contest_pool;
+
+  /**
+   * The games that received updates from the players since the last call to
+   * update_games(), in the order of the first update.
+   */
+  std::vector<iscool::net::channel_id> dirty_games;
+
+  /// The date of the last processed message.
+  std::chrono::nanoseconds last_message_date;
+
+  /**
+   * The system timings of the games released by the shard, until they are
+   * collected by the main thread.
+   */
+  bim::game::system_timings system_timings;
+  std::mutex system_timings_mutex;
+
+  /// Null when the games of this shard are processed in the main thread.
+  std::unique_ptr<shard_thread> thread;
+};
+
 bim::server::game_service::game_service(const config& config,
                                         iscool::net::socket_stream& socket,
                                         session_service& session,
@@ -435,15 +594,51 @@ bim::server::game_service::game_service(const config& config,
         config.game_service_coins_per_short_game_defeat)
   , m_coins_per_short_game_draw(config.game_service_coins_per_short_game_draw)
   , m_checksum_validation(config.game_service_enable_checksum_validation)
-  , m_message_pool(64)
+  , m_system_timings(config.game_service_enable_system_timings)
+  , m_bot_think_budget(config.game_service_bot_think_budget)
 {
   if (config.enable_contest_timeline_recording)
     m_contest_timeline_service.reset(new contest_timeline_service(config));
 
+  const std::size_t shard_count =
+      std::max<std::size_t>(1, config.game_service_shard_count);
+  m_shards.reserve(shard_count);
+
+  for (std::size_t i = 0; i != shard_count; ++i)
+    m_shards.emplace_back(new shard());
+
+  if (config.game_service_shard_count != 0)
+    {
+      ic_log(iscool::log::nature::info(), "game_service",
+             "Running the games in {} threads.", shard_count);
+
+      m_dispatch_scheduled.reset(new std::atomic<bool>(false));
+
+      for (const std::unique_ptr<shard>& s : m_shards)
+        {
+          s->thread.reset(new shard_thread());
+          s->thread->thread =
+              std::thread(&game_service::run_shard, this, std::ref(*s));
+        }
+    }
+
   schedule_clean_up();
 }
 
-bim::server::game_service::~game_service() = default;
+bim::server::game_service::~game_service()
+{
+  for (const std::unique_ptr<shard>& s : m_shards)
+    if (s->thread)
+      {
+        s->thread->quit.store(true);
+        s->thread->pending.store(true);
+        s->thread->pending.notify_one();
+      }
+
+  for (const std::unique_ptr<shard>& s : m_shards)
+    if (s->thread)
+      s->thread->thread.join();
+}
 
 bool bim::server::game_service::is_in_active_game(
     iscool::net::session_id session) const
@@ -457,20 +652,20 @@ bool bim::server::game_service::is_in_active_game(
 bool bim::server::game_service::is_playing(
     iscool::net::channel_id channel) const
 {
-  const game_map::const_iterator it = m_games.find(channel);
+  const game_summary_map::const_iterator it = m_games.find(channel);
 
-  return (it != m_games.end()) && it->second.contest_result.still_running();
+  return (it != m_games.end()) && it->second.playing;
 }
 
 std::optional<bim::server::game_info>
 bim::server::game_service::find_game(iscool::net::channel_id channel) const
 {
-  const game_map::const_iterator it = m_games.find(channel);
+  const game_summary_map::const_iterator it = m_games.find(channel);
 
   if (it == m_games.end())
     return std::nullopt;
 
-  return game_info{ .fingerprint = it->second.contest_fingerprint(),
+  return game_info{ .fingerprint = it->second.fingerprint,
                     .channel = channel,
                     .sessions = it->second.sessions };
 }
@@ -513,46 +708,38 @@ bim::server::game_info bim::server::game_service::new_game(
   ic_log(iscool::log::nature::info(), "game_service",
          "Creating new game {} for {} players.", channel, (int)player_count);
 
-  game& game =
-      m_games
-          .emplace(std::piecewise_construct, std::forward_as_tuple(channel),
-                   std::forward_as_tuple(player_count, m_random(), features,
-                                         final_sessions, reward_availability,
-                                         bot_index))
-          .first->second;
-
-  for (int i = 0; i != player_count; ++i)
-    m_session_to_channel[final_sessions[i]] = channel;
-
-  const std::chrono::nanoseconds now =
-      iscool::time::now<std::chrono::nanoseconds>();
+  const bim::game::contest_fingerprint contest_fingerprint = {
+    .seed = m_random(),
+    .features = features,
+    .player_count = player_count,
+    .crate_probability = bim::game::g_default_crate_probability,
+    .arena_width = bim::game::g_default_arena_width,
+    .arena_height = bim::game::g_default_arena_height
+  };
 
-  game.release_game_at_this_date = now + m_clean_up_interval;
+  m_games.emplace(channel, game_summary{ .fingerprint = contest_fingerprint,
+                                         .sessions = final_sessions,
+                                         .playing = true });
 
   for (int i = 0; i != player_count; ++i)
-    {
-      game.active[i] = true;
-      game.release_player_at_this_date[i] =
-          now + m_disconnection_inactivity_delay;
-    }
-
-  // No release date for bots.
-  if (bot_index)
-    game.release_player_at_this_date[*bot_index] =
-        std::chrono::nanoseconds::max();
+    m_session_to_channel[final_sessions[i]] = channel;
 
-  const bim::game::contest_fingerprint contest_fingerprint =
-      game.contest_fingerprint();
-
-  if (m_contest_timeline_service)
-    game.timeline_writer = m_contest_timeline_service->open(
-        channel, contest_fingerprint, game.bot);
+  post(channel_shard(channel),
+       shard_command{ .kind = shard_command_kind::new_game,
+                      .now = iscool::time::now<std::chrono::nanoseconds>(),
+                      .channel = channel,
+                      .player_count = player_count,
+                      .seed = contest_fingerprint.seed,
+                      .features = features,
+                      .sessions = final_sessions,
+                      .reward_availability = reward_availability,
+                      .bot_index = bot_index });
 
   m_statistics.record_game_start(player_count);
 
   return game_info{ .fingerprint = contest_fingerprint,
                     .channel = channel,
-                    .sessions = game.sessions };
+                    .sessions = final_sessions };
 }
 
 void bim::server::game_service::process(const iscool::net::endpoint& endpoint,
@@ -561,9 +748,8 @@ void bim::server::game_service::process(const iscool::net::endpoint& endpoint,
   assert(message.get_session_id() != 0);
 
   const iscool::net::channel_id channel = message.get_channel_id();
-  const game_map::iterator it = m_games.find(channel);
 
-  if (it == m_games.end())
+  if (m_games.find(channel) == m_games.end())
     {
       ic_log(iscool::log::nature::info(), "game_service",
              "Game with channel {} does not exist.", channel);
@@ -572,24 +758,278 @@ void bim::server::game_service::process(const iscool::net::endpoint& endpoint,
 
   const std::chrono::nanoseconds now =
       iscool::time::now<std::chrono::nanoseconds>();
+  shard& s = channel_shard(channel);
+
+  if (!s.thread)
+    {
+      process(s, endpoint, message, now);
+      schedule_update_games();
+    }
+  else
+    post(s, shard_command{ .kind = shard_command_kind::message,
+                           .now = now,
+                           .channel = channel,
+                           .endpoint = endpoint,
+                           .message = message });
+}
+
+bim::server::game_service::shard&
+bim::server::game_service::channel_shard(iscool::net::channel_id channel)
+{
+  return *m_shards[channel % m_shards.size()];
+}
+
+void bim::server::game_service::post(shard& s, const shard_command& command)
+{
+  if (!s.thread)
+    {
+      execute(s, command);
+      return;
+    }
+
+  // The queue is full if the shard is late. Maybe it is waiting for some
+  // room in its event queue, so we must dispatch them while we wait.
+  while (!s.thread->commands.push(command))
+    {
+      dispatch_events();
+      std::this_thread::yield();
+    }
+
+  s.thread->pending.store(true);
+  s.thread->pending.notify_one();
+}
+
+void bim::server::game_service::run_shard(shard& s)
+{
+  shard_thread& thread = *s.thread;
+
+  while (true)
+    {
+      thread.pending.wait(false);
+
+      // Clear the flag before consuming the commands, such that any command
+      // pushed after the consumption triggers a new iteration.
+      thread.pending.store(false);
+
+      thread.commands.consume_all(
+          [this, &s](const shard_command& command) -> void
+            {
+              execute(s, command);
+            });
+
+      // All the updates received in this pass are applied at once.
+      update_games(s);
+
+      if (thread.quit.load())
+        break;
+    }
+}
+
+void bim::server::game_service::execute(shard& s,
+                                        const shard_command& command)
+{
+  switch (command.kind)
+    {
+    case shard_command_kind::message:
+      process(s, command.endpoint, command.message, command.now);
+      break;
+    case shard_command_kind::new_game:
+      create_game(s, command);
+      break;
+    case shard_command_kind::clean_up:
+      clean_up(s, command.now);
+      break;
+    }
+}
+
+void bim::server::game_service::create_game(shard& s,
+                                            const shard_command& command)
+{
+  game& game = s.games
+                   .emplace(std::piecewise_construct,
+                            std::forward_as_tuple(command.channel),
+                            std::forward_as_tuple(
+                                s.contest_pool.acquire(
+                                    { .seed = command.seed,
+                                      .features = command.features,
+                                      .player_count = command.player_count,
+                                      .crate_probability = bim::game::
+                                          g_default_crate_probability,
+                                      .arena_width =
+                                          bim::game::g_default_arena_width,
+                                      .arena_height =
+                                          bim::game::g_default_arena_height }),
+                                command.player_count, command.seed,
+                                command.features, command.sessions,
+                                command.reward_availability, command.bot_index,
+                                m_bot_think_budget))
+                   .first->second;
+
+  game.release_game_at_this_date = command.now + m_clean_up_interval;
+  s.game_expiry.push(command.channel, game.release_game_at_this_date);
+
+  if (m_system_timings)
+    game.contest->measure_systems(&game.system_timings);
+
+  for (int i = 0; i != command.player_count; ++i)
+    {
+      game.active[i] = true;
+      game.release_player_at_this_date[i] =
+          command.now + m_disconnection_inactivity_delay;
+    }
+
+  // No release date for bots.
+  if (command.bot_index)
+    game.release_player_at_this_date[*command.bot_index] =
+        std::chrono::nanoseconds::max();
+
+  if (m_contest_timeline_service)
+    game.timeline_writer = m_contest_timeline_service->open(
+        command.channel, game.contest_fingerprint(), game.bot);
+}
+
+void bim::server::game_service::process(shard& s,
+                                        const iscool::net::endpoint& endpoint,
+                                        const iscool::net::message& message,
+                                        std::chrono::nanoseconds now)
+{
+  const iscool::net::channel_id channel = message.get_channel_id();
+  const game_map::iterator it = s.games.find(channel);
+
+  // The game may have been cleaned up by the shard while the message was
+  // waiting in the queue.
+  if (it == s.games.end())
+    return;
 
   it->second.release_game_at_this_date = now + m_clean_up_interval;
+  s.last_message_date = now;
 
   switch (message.get_type())
     {
     case bim::net::message_type::ready:
-      mark_as_ready(endpoint, message.get_session_id(), channel, it->second,
-                    now);
+      mark_as_ready(s, endpoint, message.get_session_id(), channel,
+                    it->second, now);
       break;
     case bim::net::message_type::game_update_from_client:
-      push_update(endpoint, channel, message, it->second, now);
+      push_update(s, endpoint, channel, message, it->second, now);
+      break;
+    }
+}
+
+void bim::server::game_service::send(shard& s,
+                                     const iscool::net::endpoint& endpoint,
+                                     const iscool::net::message& message,
+                                     iscool::net::session_id session,
+                                     iscool::net::channel_id channel)
+{
+  if (!s.thread)
+    m_message_stream.send(endpoint, message, session, channel);
+  else
+    emit(s, shard_event{ .kind = shard_event_kind::send,
+                         .channel = channel,
+                         .session = session,
+                         .endpoint = endpoint,
+                         .message = message });
+}
+
+void bim::server::game_service::emit(shard& s, const shard_event& event)
+{
+  if (!s.thread)
+    {
+      dispatch(event);
+      return;
+    }
+
+  // The main thread dispatches the events while it waits for the shards, so
+  // there will be some room eventually, except if we are shutting down.
+  while (!s.thread->events.push(event))
+    {
+      if (s.thread->quit.load())
+        return;
+
+      std::this_thread::yield();
+    }
+
+  signal_events();
+}
+
+/**
+ * Called from the shards' threads to wake up the main thread when there are
+ * events to dispatch. The delayed call is the way the other threads pass work
+ * to the main thread, like the socket does for the received messages.
+ */
+void bim::server::game_service::signal_events()
+{
+  // The flag is cleared by the main thread before consuming the events, so
+  // the events pushed after the consumption schedule a new call.
+  if (m_dispatch_scheduled->exchange(true))
+    return;
+
+  iscool::schedule::delayed_call(
+      [this,
+       scheduled = std::weak_ptr<std::atomic<bool>>(m_dispatch_scheduled)]()
+          -> void
+        {
+          const std::shared_ptr<std::atomic<bool>> flag = scheduled.lock();
+
+          // The service has been destroyed before the call.
+          if (!flag)
+            return;
+
+          flag->store(false);
+          dispatch_events();
+        });
+}
+
+void bim::server::game_service::dispatch_events()
+{
+  for (const std::unique_ptr<shard>& s : m_shards)
+    {
+      assert(s->thread);
+
+      s->thread->events.consume_all(
+          [this](const shard_event& event) -> void
+            {
+              dispatch(event);
+            });
+    }
+}
+
+void bim::server::game_service::dispatch(const shard_event& event)
+{
+  switch (event.kind)
+    {
+    case shard_event_kind::send:
+      m_message_stream.send(event.endpoint, event.message, event.session,
+                            event.channel);
+      break;
+    case shard_event_kind::karma_disconnection:
+      m_session_service.update_karma_disconnection(event.session);
+      break;
+    case shard_event_kind::karma_short_game:
+      m_session_service.update_karma_short_game(event.session);
+      break;
+    case shard_event_kind::karma_good_behavior:
+      m_session_service.update_karma_good_behavior(event.session);
+      break;
+    case shard_event_kind::game_over:
+      {
+        const game_summary_map::iterator it = m_games.find(event.channel);
+
+        if (it != m_games.end())
+          it->second.playing = false;
+        break;
+      }
+    case shard_event_kind::game_released:
+      release_game(event.channel);
       break;
     }
 }
 
 void bim::server::game_service::mark_as_ready(
-    const iscool::net::endpoint& endpoint, iscool::net::session_id session,
-    iscool::net::channel_id channel, game& game, std::chrono::nanoseconds now)
+    shard& s, const iscool::net::endpoint& endpoint,
+    iscool::net::session_id session, iscool::net::channel_id channel,
+    game& game, std::chrono::nanoseconds now)
 {
   const std::size_t existing_index = game.session_index(session);
 
@@ -614,7 +1054,7 @@ void bim::server::game_service::mark_as_ready(
   game.release_player_at_this_date[existing_index] =
       now + m_disconnection_inactivity_delay;
 
-  check_drop_desynchronized_player(channel, game, now);
+  check_drop_desynchronized_player(s, channel, game, now);
 
   int ready_count = 0;
   int active_count = 0;
@@ -636,17 +1076,17 @@ void bim::server::game_service::mark_as_ready(
   ic_log(iscool::log::nature::info(), "game_service",
          "Channel {} all players ready, session {}.", channel, session);
 
-  const iscool::net::message_pool::slot s = m_message_pool.pick_available();
-  bim::net::start().build_message(*s.value);
+  const iscool::net::message_pool::slot slot = s.message_pool.pick_available();
+  bim::net::start().build_message(*slot.value);
 
-  m_message_stream.send(endpoint, *s.value, session, channel);
-  m_message_pool.release(s.id);
+  send(s, endpoint, *slot.value, session, channel);
+  s.message_pool.release(slot.id);
 }
 
 void bim::server::game_service::push_update(
-    const iscool::net::endpoint& endpoint, iscool::net::channel_id channel,
-    const iscool::net::message& message, game& game,
-    std::chrono::nanoseconds now)
+    shard& s, const iscool::net::endpoint& endpoint,
+    iscool::net::channel_id channel, const iscool::net::message& message,
+    game& game, std::chrono::nanoseconds now)
 {
   const std::optional<bim::net::game_update_from_client> update =
       bim::net::try_deserialize_message<bim::net::game_update_from_client>(
@@ -684,8 +1124,7 @@ void bim::server::game_service::push_update(
 
       if (m_checksum_validation && game.contest_result.still_running())
         {
-          game.active[player_index] = false;
-          m_session_service.update_karma_disconnection(session);
+          disconnect_player(s, game, player_index);
           return;
         }
     }
@@ -696,37 +1135,129 @@ void bim::server::game_service::push_update(
   if (*tick_count != 0)
     queue_actions(*update, player_index, game);
 
-  bool do_send_actions = true;
+  // The simulation is not updated here but in update_games(), once for all
+  // the updates received in the same pass, whatever the number of players
+  // who sent them.
+  game.pending_reply[player_index] = endpoint;
+
+  if (!game.dirty)
+    {
+      game.dirty = true;
+      s.dirty_games.push_back(channel);
+    }
+}
+
+void bim::server::game_service::schedule_update_games()
+{
+  if (m_update_games_connection.connected())
+    return;
+
+  m_update_games_connection = iscool::schedule::delayed_call(
+      [this]() -> void
+        {
+          m_update_games_connection.disconnect();
+
+          for (const std::unique_ptr<shard>& s : m_shards)
+            if (!s->thread)
+              update_games(*s);
+        });
+}
+
+void bim::server::game_service::update_games(shard& s)
+{
+  for (const iscool::net::channel_id channel : s.dirty_games)
+    {
+      const game_map::iterator it = s.games.find(channel);
+
+      // The game may have been cleaned up since it was marked.
+      if (it != s.games.end())
+        update_game(s, channel, it->second, s.last_message_date);
+    }
+
+  s.dirty_games.clear();
+}
+
+void bim::server::game_service::update_game(shard& s,
+                                            iscool::net::channel_id channel,
+                                            game& game,
+                                            std::chrono::nanoseconds now)
+{
+  game.dirty = false;
+
   const simulation_state state = game.update();
+  bool game_over = false;
 
   switch (state)
     {
     case simulation_state::frozen:
-      check_drop_desynchronized_player(channel, game, now);
+      check_drop_desynchronized_player(s, channel, game, now);
       break;
     case simulation_state::playing:
       break;
     case simulation_state::over:
-      record_game_over(channel, game);
+      record_game_over(s, channel, game);
       [[fallthrough]];
     case simulation_state::flushing:
-      if (game.game_over_tick
-          <= game.completed_tick_count_per_player[player_index])
+      game_over = true;
+      break;
+    }
+
+  // The players at the same tick receive the same actions, so the messages
+  // are encoded once per tick and shared by these players until the next
+  // update of the simulation. Only the header differs, and it is set when
+  // sending.
+  boost::container::static_vector<encoded_actions,
+                                  bim::game::g_max_player_count>
+      encoded;
+
+  for (std::uint8_t player_index = 0; player_index != game.player_count;
+       ++player_index)
+    {
+      const std::optional<iscool::net::endpoint>& endpoint =
+          game.pending_reply[player_index];
+
+      if (!endpoint)
+        continue;
+
+      const iscool::net::session_id session = game.sessions[player_index];
+
+      // Keep sending the actions to the player to notify it about any
+      // updates, even if the game could not be updated. Even if one player is
+      // frozen we must keep them updated.
+      //
+      // Except if the player has reached the end of the game, in which case
+      // we send the game over instead.
+      if (game_over
+          && (game.game_over_tick
+              <= game.completed_tick_count_per_player[player_index]))
+        send_game_over(s, *endpoint, session, channel, game);
+      else
         {
-          do_send_actions = false;
-          send_game_over(endpoint, session, channel, game);
+          const std::uint32_t from_tick =
+              game.completed_tick_count_per_player[player_index];
+          auto it = std::find_if(encoded.begin(), encoded.end(),
+                                 [=](const encoded_actions& e) -> bool
+                                   {
+                                     return e.from_tick == from_tick;
+                                   });
+
+          if (it == encoded.end())
+            {
+              encoded.push_back(encoded_actions{
+                  .from_tick = from_tick,
+                  .slot = s.message_pool.pick_available() });
+              it = encoded.end() - 1;
+              build_actions_message(*it->slot.value, from_tick, game);
+            }
+
+          send(s, *endpoint, *it->slot.value, session, channel);
         }
-      break;
+
+      game.pending_reply[player_index].reset();
     }
 
-  // Keep sending the actions to the player to notify it about any updates,
-  // even if the game could not be updated. Even if one player is frozen we
-  // must keep them updated.
-  //
-  // Except if we sent the game over, in which case there's no need for an
-  // update of the other players.
-  if (do_send_actions)
-    send_actions(endpoint, session, channel, player_index, game);
+  for (const encoded_actions& e : encoded)
+    s.message_pool.release(e.slot.id);
 }
 
 /// Validate the integrity of the message.
@@ -816,7 +1347,7 @@ void bim::server::game_service::queue_actions(
     const bim::net::game_update_from_client& message, std::size_t player_index,
     game& game)
 {
-  std::vector<bim::game::player_action>& local_actions =
+  bim::ring_buffer<bim::game::player_action>& local_actions =
       game.actions[player_index];
 
   const std::size_t tick_count = message.actions.size();
@@ -831,22 +1362,18 @@ void bim::server::game_service::queue_actions(
   game.completed_tick_count_per_player[player_index] = message.from_tick;
 
   // Apply the remaining actions.
-  local_actions.insert(local_actions.end(),
-                       message.actions.begin() + tick_index,
+  local_actions.append(message.actions.begin() + tick_index,
                        message.actions.end());
 }
 
-void bim::server::game_service::send_actions(
-    const iscool::net::endpoint& endpoint, iscool::net::session_id session,
-    iscool::net::channel_id channel, std::size_t player_index,
-    const game& game)
+void bim::server::game_service::build_actions_message(
+    iscool::net::message& result,
+    std::uint32_t completed_tick_count_for_player, const game& game) const
 {
   // All we need to send to a player P is the sequence of actions from the
   // other players that happened between the last synchronized tick of P and
-  // the smallest predicted tick reached by all the players.
-
-  const std::uint32_t completed_tick_count_for_player =
-      game.completed_tick_count_per_player[player_index];
+  // the smallest predicted tick reached by all the players. Thus the message
+  // depends only on the last synchronized tick of P.
 
   // The player may be farther than the point confirmed by all players (e.g.
   // some players are late in the synchronization).
@@ -858,14 +1385,15 @@ void bim::server::game_service::send_actions(
   // after the synchronized tick of this player.
   bim_assume(game.simulation_tick >= completed_tick_count_for_player);
   const std::size_t tick_count = std::min<std::size_t>(
-      255, game.simulation_tick - completed_tick_count_for_player);
+      bim::net::game_update_from_server::max_action_count,
+      game.simulation_tick - completed_tick_count_for_player);
 
   bim::net::game_update_from_server message;
   message.from_tick = completed_tick_count_for_player;
   message.final_checksum =
       game.simulation_checksum[completed_tick_count_for_player + tick_count
                                - game.completed_tick_count_all];
-  message.actions.resize(game.player_count);
+  message.player_count = game.player_count;
 
   for (std::uint8_t player = 0; player != game.player_count; ++player)
     {
@@ -891,21 +1419,19 @@ void bim::server::game_service::send_actions(
       const std::size_t adjusted_tick_count =
           std::min(tick_count, action_count - tick_start_index);
 
-      const std::vector<bim::game::player_action>::const_iterator begin =
-          game.actions[player].begin() + tick_start_index;
-      message.actions[player].insert(message.actions[player].end(), begin,
-                                     begin + adjusted_tick_count);
-    }
+      const std::array<std::span<const bim::game::player_action>, 2> range =
+          game.actions[player].range(tick_start_index, adjusted_tick_count);
 
-  const iscool::net::message_pool::slot s = m_message_pool.pick_available();
-  message.build_message(*s.value);
+      message.actions[player].assign(range[0].begin(), range[0].end());
+      message.actions[player].insert(message.actions[player].end(),
+                                     range[1].begin(), range[1].end());
+    }
 
-  m_message_stream.send(endpoint, *s.value, session, channel);
-  m_message_pool.release(s.id);
+  message.build_message(result);
 }
 
 void bim::server::game_service::record_game_over(
-    iscool::net::channel_id channel, game& game) const
+    shard& s, iscool::net::channel_id channel, game& game)
 {
   assert(!game.contest_result.still_running());
 
@@ -955,32 +1481,38 @@ void bim::server::game_service::record_game_over(
       // In doubt, we do not update the karma of the winner.
       for (int i = 0; i != game.player_count; ++i)
         if ((i != game.winner_index) && !game.bot[i])
-          m_session_service.update_karma_short_game(game.sessions[i]);
+          emit(s, shard_event{ .kind = shard_event_kind::karma_short_game,
+                               .session = game.sessions[i] });
     }
   else
     for (int i = 0; i != game.player_count; ++i)
       if (game.active[i] && !game.bot[i])
-        m_session_service.update_karma_good_behavior(game.sessions[i]);
+        emit(s, shard_event{ .kind = shard_event_kind::karma_good_behavior,
+                             .session = game.sessions[i] });
+
+  emit(s, shard_event{ .kind = shard_event_kind::game_over,
+                       .channel = channel });
 }
 
 void bim::server::game_service::send_game_over(
-    const iscool::net::endpoint& endpoint, iscool::net::session_id session,
-    iscool::net::channel_id channel, const game& game)
+    shard& s, const iscool::net::endpoint& endpoint,
+    iscool::net::session_id session, iscool::net::channel_id channel,
+    const game& game)
 {
   assert(!game.contest_result.still_running());
 
   const bim::net::game_over message(
       game.winner_index, game.reward_coins[game.session_index(session)]);
-  const iscool::net::message_pool::slot s = m_message_pool.pick_available();
-  message.build_message(*s.value);
+  const iscool::net::message_pool::slot slot = s.message_pool.pick_available();
+  message.build_message(*slot.value);
 
-  m_message_stream.send(endpoint, *s.value, session, channel);
-  m_message_pool.release(s.id);
+  send(s, endpoint, *slot.value, session, channel);
+  s.message_pool.release(slot.id);
 }
 
 void bim::server::game_service::check_drop_desynchronized_player(
-    iscool::net::channel_id channel, game& game,
-    std::chrono::nanoseconds now) const
+    shard& s, iscool::net::channel_id channel, game& game,
+    std::chrono::nanoseconds now)
 {
   // Exclude the players for which we have no news since a long time.
   for (int i = 0; i != game.player_count; ++i)
@@ -991,10 +1523,7 @@ void bim::server::game_service::check_drop_desynchronized_player(
                "lateness. No news since {}.",
                i, game.sessions[i], channel, m_disconnection_inactivity_delay);
 
-        assert(!game.bot[i]);
-
-        game.active[i] = false;
-        m_session_service.update_karma_disconnection(game.sessions[i]);
+        disconnect_player(s, game, i);
       }
 
   bim::game::per_player_array<int> player_tick;
@@ -1038,10 +1567,7 @@ void bim::server::game_service::check_drop_desynchronized_player(
              second_slowest_tick - slowest_tick, second_slowest_tick,
              m_disconnection_lateness_threshold_in_ticks);
 
-      assert(!game.bot[i]);
-
-      game.active[i] = false;
-      m_session_service.update_karma_disconnection(game.sessions[i]);
+      disconnect_player(s, game, i);
       return;
     }
 
@@ -1061,13 +1587,20 @@ void bim::server::game_service::check_drop_desynchronized_player(
              fastest_tick - second_fastest_tick, second_fastest_tick,
              m_disconnection_earliness_threshold_in_ticks);
 
-      assert(!game.bot[i]);
-
-      game.active[i] = false;
-      m_session_service.update_karma_disconnection(game.sessions[i]);
+      disconnect_player(s, game, i);
     }
 }
 
+void bim::server::game_service::disconnect_player(shard& s, game& game,
+                                                  int player_index)
+{
+  assert(!game.bot[player_index]);
+
+  game.active[player_index] = false;
+  emit(s, shard_event{ .kind = shard_event_kind::karma_disconnection,
+                       .session = game.sessions[player_index] });
+}
+
 void bim::server::game_service::schedule_clean_up()
 {
   m_clean_up_connection = iscool::schedule::delayed_call(
@@ -1082,36 +1615,86 @@ void bim::server::game_service::clean_up()
 {
   const std::chrono::nanoseconds now =
       iscool::time::now<std::chrono::nanoseconds>();
-  const std::size_t old_game_count = m_games.size();
 
-  for (game_map::iterator it = m_games.begin(); it != m_games.end();)
-    if (it->second.release_game_at_this_date <= now)
-      {
-        clean_up(it->first, it->second);
-        it = m_games.erase(it);
-      }
-    else
-      ++it;
+  for (const std::unique_ptr<shard>& s : m_shards)
+    post(*s,
+         shard_command{ .kind = shard_command_kind::clean_up, .now = now });
 
-  if (old_game_count != m_games.size())
-    ic_log(iscool::log::nature::info(), "game_service",
-           "Game clean up {} -> {}.", old_game_count, m_games.size());
+  if (m_system_timings)
+    collect_system_timings();
 
   schedule_clean_up();
 }
 
-void bim::server::game_service::clean_up(iscool::net::channel_id channel,
-                                         const game& g)
+void bim::server::game_service::clean_up(shard& s,
+                                         std::chrono::nanoseconds now)
+{
+  const std::size_t old_game_count = s.games.size();
+
+  // The games are not moved in the queue when they receive a message; they
+  // are queued again for their new date when their previous date is reached.
+  s.game_expiry.pop_expired(
+      now,
+      [this, &s, now](iscool::net::channel_id channel)
+          -> std::optional<std::chrono::nanoseconds>
+        {
+          const game_map::iterator it = s.games.find(channel);
+
+          if (it == s.games.end())
+            return std::nullopt;
+
+          if (it->second.release_game_at_this_date > now)
+            return it->second.release_game_at_this_date;
+
+          if (m_system_timings)
+            {
+              const std::lock_guard<std::mutex> lock(s.system_timings_mutex);
+              s.system_timings += it->second.system_timings;
+            }
+
+          emit(s, shard_event{ .kind = shard_event_kind::game_released,
+                               .channel = it->first });
+          s.contest_pool.release(std::move(it->second.contest));
+          s.games.erase(it);
+
+          return std::nullopt;
+        });
+
+  if (old_game_count != s.games.size())
+    ic_log(iscool::log::nature::info(), "game_service",
+           "Game clean up {} -> {}.", old_game_count, s.games.size());
+}
+
+void bim::server::game_service::collect_system_timings()
+{
+  bim::game::system_timings timings;
+
+  for (const std::unique_ptr<shard>& s : m_shards)
+    {
+      const std::lock_guard<std::mutex> lock(s->system_timings_mutex);
+      timings += s->system_timings;
+      s->system_timings = bim::game::system_timings();
+    }
+
+  m_statistics.record_game_system_timings(timings);
+}
+
+void bim::server::game_service::release_game(iscool::net::channel_id channel)
 {
   ic_log(iscool::log::nature::info(), "game_service", "Cleaning up game {}.",
          channel);
 
-  m_statistics.record_game_end(g.player_count);
+  const game_summary_map::iterator it = m_games.find(channel);
+  assert(it != m_games.end());
+
+  const game_summary& g = it->second;
+
+  m_statistics.record_game_end(g.fingerprint.player_count);
 
   const session_to_channel_map::const_iterator eit =
       m_session_to_channel.end();
 
-  for (int i = 0; i != g.player_count; ++i)
+  for (int i = 0; i != g.fingerprint.player_count; ++i)
     {
       // The sessions may have been assigned to another game between the end of
       // the game and the clean-up, for example if the player has asked for
@@ -1123,4 +1706,6 @@ void bim::server::game_service::clean_up(iscool::net::channel_id channel,
       if ((stc != eit) && (stc->second == channel))
         m_session_to_channel.erase(stc);
     }
+
+  m_games.erase(it);
 }
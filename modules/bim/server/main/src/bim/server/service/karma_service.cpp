@@ -3,6 +3,8 @@
 
 #include <bim/server/config.hpp>
 
+#include <bim/deadline_queue.impl.hpp>
+
 #include <iscool/log/log.hpp>
 #include <iscool/log/nature/info.hpp>
 #include <iscool/schedule/delayed_call.hpp>
@@ -10,6 +12,8 @@
 
 #include <boost/unordered/unordered_map.hpp>
 
+#include <optional>
+
 struct bim::server::karma_service::client_info
 {
   std::chrono::minutes let_go_at_this_date;
@@ -72,6 +76,9 @@ void bim::server::karma_service::remove(
     return;
 
   --it->second.session_count;
+
+  if (it->second.session_count == 0)
+    m_idle_clients.push_back(address);
 }
 
 bim::server::karma_service::update_result
@@ -123,6 +130,7 @@ bim::server::karma_service::add_karma(const boost::asio::ip::address& address,
   const std::chrono::minutes now = iscool::time::now<std::chrono::minutes>();
 
   it->second.let_go_at_this_date = now + m_blacklist_time_out;
+  m_blacklist_expiry.push(address, it->second.let_go_at_this_date);
 
   return update_result::kick_out;
 }
@@ -144,18 +152,43 @@ void bim::server::karma_service::review()
 
   const std::size_t old_client_count = m_client.size();
 
-  for (client_map::iterator it = m_client.begin(), eit = m_client.end();
-       it != eit;)
-    if ((it->second.karma >= 0) && (it->second.session_count == 0))
-      it = m_client.erase(it);
-    else if ((it->second.karma < 0) && (it->second.let_go_at_this_date <= now))
-      {
-        ic_log(iscool::log::nature::info(), "karma_service",
-               "Reopening the doors for {}.", it->first.to_string());
-        it = m_client.erase(it);
-      }
-    else
-      ++it;
+  // The clients in good standing are forgotten once they have no session.
+  for (const boost::asio::ip::address& address : m_idle_clients)
+    {
+      const client_map::iterator it = m_client.find(address);
+
+      if ((it != m_client.end()) && (it->second.karma >= 0)
+          && (it->second.session_count == 0))
+        m_client.erase(it);
+    }
+
+  m_idle_clients.clear();
+
+  m_blacklist_expiry.pop_expired(
+      now,
+      [this, now](const boost::asio::ip::address& address)
+          -> std::optional<std::chrono::nanoseconds>
+        {
+          const client_map::iterator it = m_client.find(address);
+
+          if (it == m_client.end())
+            return std::nullopt;
+
+          if (it->second.karma < 0)
+            {
+              // The client has been blacklisted again since it was queued.
+              if (it->second.let_go_at_this_date > now)
+                return it->second.let_go_at_this_date;
+
+              ic_log(iscool::log::nature::info(), "karma_service",
+                     "Reopening the doors for {}.", it->first.to_string());
+              m_client.erase(it);
+            }
+          else if (it->second.session_count == 0)
+            m_client.erase(it);
+
+          return std::nullopt;
+        });
 
   if (old_client_count != m_client.size())
     ic_log(iscool::log::nature::info(), "karma_service",
@@ -11,6 +11,7 @@
 
 #include <bim/game/constant/max_player_count.hpp>
 
+#include <bim/deadline_queue.impl.hpp>
 #include <bim/to_underlying.hpp>
 
 #include <iscool/log/log.hpp>
@@ -74,6 +75,14 @@ struct bim::server::matchmaking_service::encounter_info
     --player_count;
   }
 
+  std::chrono::nanoseconds next_release_date() const
+  {
+    assert(player_count > 0);
+
+    return *std::min_element(release_at_this_date.begin(),
+                             release_at_this_date.begin() + player_count);
+  }
+
   size_t session_index(iscool::net::session_id session) const
   {
     return std::find(sessions.begin(), sessions.begin() + player_count,
@@ -128,6 +137,8 @@ bim::net::encounter_id bim::server::matchmaking_service::new_encounter(
   encounter.date_for_bot[0] = now + m_delay_for_bot;
   encounter.ready.fill(false);
 
+  m_encounter_expiry.push(encounter_id, encounter.release_at_this_date[0]);
+
   send_game_on_hold(endpoint, request_token, session, encounter_id,
                     encounter.player_count);
 
@@ -437,31 +448,38 @@ void bim::server::matchmaking_service::clean_up()
 
   const std::size_t old_encounter_count = m_encounters.size();
 
-  for (encounter_map::iterator it = m_encounters.begin(),
-                               eit = m_encounters.end();
-       it != eit;)
-    {
-      const bim::net::encounter_id encounter_id = it->first;
-      encounter_info& encounter = it->second;
+  // Only the encounters in which a session may have expired are visited.
+  // The refreshed sessions do not move their encounter in the queue, the
+  // encounter is queued again for its new date when the previous one is
+  // reached.
+  m_encounter_expiry.pop_expired(
+      now,
+      [this, now](bim::net::encounter_id encounter_id)
+          -> std::optional<std::chrono::nanoseconds>
+        {
+          const encounter_map::iterator it = m_encounters.find(encounter_id);
+          assert(it != m_encounters.end());
 
-      remove_inactive_sessions(now, encounter_id, encounter);
+          encounter_info& encounter = it->second;
 
-      if (encounter.player_count == 0)
-        {
-          ic_log(iscool::log::nature::info(), "matchmaking_service",
-                 "Cleaning up encounter {}.", encounter_id);
+          remove_inactive_sessions(now, encounter_id, encounter);
+
+          if (encounter.player_count == 0)
+            {
+              ic_log(iscool::log::nature::info(), "matchmaking_service",
+                     "Cleaning up encounter {}.", encounter_id);
+
+              m_done_encounters.emplace_back(encounter_id);
+              m_encounters.erase(it);
+
+              return std::nullopt;
+            }
 
-          m_done_encounters.emplace_back(encounter_id);
-          it = m_encounters.erase(it);
-        }
-      else
-        {
           ic_log(iscool::log::nature::info(), "matchmaking_service",
                  "Keeping encounter {}.", encounter_id);
 
-          ++it;
-        }
-    }
+          return encounter.next_release_date();
+        });
 
   if (old_encounter_count != m_encounters.size())
     ic_log(iscool::log::nature::info(), "matchmaking_service",
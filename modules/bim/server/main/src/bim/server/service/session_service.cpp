@@ -6,6 +6,8 @@
 
 #include <bim/business/post.hpp>
 
+#include <bim/deadline_queue.impl.hpp>
+
 #include <iscool/log/log.hpp>
 #include <iscool/log/nature/error.hpp>
 #include <iscool/log/nature/info.hpp>
@@ -14,6 +16,7 @@
 #include <iscool/time/now.hpp>
 
 #include <cassert>
+#include <optional>
 
 struct bim::server::session_service::client_info
 {
@@ -143,6 +146,7 @@ bim::server::session_service::create_or_refresh_session(
                       .user_id = 0,
                       .session_token = session_token };
 
+  m_client_expiry.push(session, client.release_at_this_date);
   m_clients.emplace(session, std::move(client));
   m_statistics.record_session_connected();
   m_karma.add(address);
@@ -264,19 +268,31 @@ void bim::server::session_service::clean_up()
 
   const std::size_t old_client_count = m_clients.size();
 
-  for (client_map::iterator it = m_clients.begin(), eit = m_clients.end();
-       it != eit;)
-    if (it->second.release_at_this_date <= now)
-      {
-        ic_log(iscool::log::nature::info(), "session_service",
-               "Disconnected {}.", it->first);
-        m_sessions.erase(it->second.token);
-        m_id_to_session.erase(it->first);
-        m_karma.remove(it->second.address);
-        it = m_clients.erase(it);
-      }
-    else
-      ++it;
+  // The refreshed sessions are not moved in the queue; they are queued again
+  // for their new date when their previous date is reached.
+  m_client_expiry.pop_expired(
+      now,
+      [this, now](iscool::net::session_id session)
+          -> std::optional<std::chrono::nanoseconds>
+        {
+          const client_map::iterator it = m_clients.find(session);
+
+          // The session was disconnected in another way.
+          if (it == m_clients.end())
+            return std::nullopt;
+
+          if (it->second.release_at_this_date > now)
+            return it->second.release_at_this_date;
+
+          ic_log(iscool::log::nature::info(), "session_service",
+                 "Disconnected {}.", it->first);
+          m_sessions.erase(it->second.token);
+          m_id_to_session.erase(it->first);
+          m_karma.remove(it->second.address);
+          m_clients.erase(it);
+
+          return std::nullopt;
+        });
 
   if (old_client_count != m_clients.size())
     {
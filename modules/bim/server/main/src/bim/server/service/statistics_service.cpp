@@ -164,6 +164,20 @@ void bim::server::statistics_service::record_game_end(
   schedule_file_dump();
 }
 
+const bim::game::system_timings&
+bim::server::statistics_service::game_system_timings() const
+{
+  return m_game_system_timings;
+}
+
+void bim::server::statistics_service::record_game_system_timings(
+    const bim::game::system_timings& timings)
+{
+  m_game_system_timings += timings;
+
+  schedule_file_dump();
+}
+
 void bim::server::statistics_service::schedule_file_dump()
 {
   if (!m_enable_file_dump || m_file_dump_connection.connected())
@@ -209,6 +223,15 @@ void bim::server::statistics_service::dump_stats_to_file()
       m_players_in_games.last_month.total(), m_games.last_hour.total(),
       m_games.last_day.total(), m_games.last_month.total());
   std::fflush(m_log_file);
+
+  for (std::size_t i = 0; i != bim::game::system_timings::system_count; ++i)
+    if (m_game_system_timings.calls[i] != 0)
+      ic_log(iscool::log::nature::info(), "statistics_service",
+             "System {}: {} calls, {} ns per call.",
+             bim::game::system_name((bim::game::system_id)i),
+             m_game_system_timings.calls[i],
+             m_game_system_timings.duration[i].count()
+                 / m_game_system_timings.calls[i]);
 }
 
 void bim::server::statistics_service::schedule_statistics_tick()
@@ -16,7 +16,9 @@
 
 #include <iscool/log/log.hpp>
 #include <iscool/log/nature/info.hpp>
+#include <iscool/net/byte_array.hpp>
 
+#include <chrono>
 #include <format>
 #include <iostream>
 #include <memory>
@@ -24,7 +26,7 @@
 
 #include <gtest/gtest.h>
 
-class many_games_test : public testing::Test
+class many_games_test : public testing::TestWithParam<std::uint16_t>
 {
 public:
   many_games_test();
@@ -39,14 +41,19 @@ protected:
 
   std::vector<std::unique_ptr<bim::server::tests::test_client>> m_clients;
   std::vector<bim::game::bot> m_bots;
+
+  /// Datagrams received by the clients, to measure the server's throughput.
+  std::uint64_t m_received_packet_count;
 };
 
 many_games_test::many_games_test()
   : m_config(
-        []()
+        [this]()
           {
             bim::server::config config = bim::server::tests::new_test_config();
 
+            config.game_service_shard_count = GetParam();
+
             config.enable_bots = true;
             config.matchmaking_delay_for_bot = std::chrono::seconds(1);
             config.matchmaking_delay_for_release = std::chrono::years(1);
@@ -62,9 +69,16 @@ many_games_test::many_games_test()
   , m_socket_stream("localhost:" + std::to_string(m_config.port),
                     iscool::net::socket_mode::client{})
   , m_message_stream(m_socket_stream)
-{}
+  , m_received_packet_count(0)
+{
+  m_socket_stream.connect_to_received(
+      [this](const iscool::net::endpoint&, const iscool::net::byte_array&)
+        {
+          ++m_received_packet_count;
+        });
+}
 
-TEST_F(many_games_test, run)
+TEST_P(many_games_test, run)
 {
   std::vector<bim::game::feature_flags> all_feature_flags_combined;
   all_feature_flags_combined.push_back({});
@@ -147,6 +161,12 @@ TEST_F(many_games_test, run)
 
   ic_log(iscool::log::nature::info(), "many_games_test", "Playing games.");
 
+  const std::chrono::steady_clock::time_point start_date =
+      std::chrono::steady_clock::now();
+  const std::uint64_t start_packet_count = m_received_packet_count;
+  const std::size_t start_bytes_in = m_socket_stream.received_bytes();
+  const std::size_t start_bytes_out = m_socket_stream.sent_bytes();
+
   do
     {
       bool updated = false;
@@ -208,4 +228,19 @@ TEST_F(many_games_test, run)
         }
     }
   while (!all_done);
+
+  const std::chrono::duration<double> duration =
+      std::chrono::steady_clock::now() - start_date;
+  const std::uint64_t packet_count =
+      m_received_packet_count - start_packet_count;
+
+  ic_log(iscool::log::nature::info(), "many_games_test",
+         "Received {} packets in {:.3f} s ({:.0f} packets/s), {} bytes in, {} "
+         "bytes out.",
+         packet_count, duration.count(), packet_count / duration.count(),
+         m_socket_stream.received_bytes() - start_bytes_in,
+         m_socket_stream.sent_bytes() - start_bytes_out);
 }
+
+INSTANTIATE_TEST_SUITE_P(many_games_shards, many_games_test,
+                         testing::Values(0, 3));
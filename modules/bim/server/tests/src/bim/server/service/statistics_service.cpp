@@ -104,3 +104,33 @@ TEST(statistics_service, disabled_stats_recording_logs_nothing)
 
   EXPECT_EQ(0, log.size());
 }
+
+TEST(statistics_service, accumulates_game_system_timings)
+{
+  const bim::server::config config = bim::server::tests::new_test_config();
+
+  bim::server::tests::fake_scheduler scheduler;
+  bim::server::statistics_service stats(config);
+
+  constexpr std::size_t bombs = (std::size_t)bim::game::system_id::update_bombs;
+  constexpr std::size_t fog = (std::size_t)bim::game::system_id::fog_of_war;
+
+  bim::game::system_timings timings;
+  timings.duration[bombs] = std::chrono::microseconds(3);
+  timings.calls[bombs] = 2;
+
+  stats.record_game_system_timings(timings);
+
+  timings.duration[fog] = std::chrono::microseconds(5);
+  timings.calls[fog] = 1;
+
+  stats.record_game_system_timings(timings);
+
+  EXPECT_EQ(std::chrono::microseconds(6),
+            stats.game_system_timings().duration[bombs]);
+  EXPECT_EQ(4, stats.game_system_timings().calls[bombs]);
+
+  EXPECT_EQ(std::chrono::microseconds(5),
+            stats.game_system_timings().duration[fog]);
+  EXPECT_EQ(1, stats.game_system_timings().calls[fog]);
+}